@@ -35,15 +35,26 @@ INCLUDEPATH += "include/UI" \
 SOURCES += \
     main.cpp \
     src/UI/PCMainUI.cpp \
+    src/UI/PCMainUIBenchmarks.cpp \
     src/Utility.cpp \
+    src/Trace.cpp \
     src/UI/UIElements.cpp \
+    src/UI/PhotosListModel.cpp \
     src/Workers/PDFGeneratorWorker.cpp \
     src/Workers/PhotoLoaderWorker.cpp \
+    src/Workers/FilePrefetcher.cpp \
+    src/Workers/DirectoryScannerWorker.cpp \
+    src/Workers/WorkSaverWorker.cpp \
     src/Widgets/PreviewW.cpp \
     src/Widgets/PhotoW.cpp \
     src/Widgets/CustomPageW.cpp \
     src/Widgets/PageW.cpp \
     src/Data/Photo.cpp \
+    src/Data/ExifReader.cpp \
+    src/Data/PhotoMetadata.cpp \
+    src/Data/ResourceStore.cpp \
+    src/Data/WorkArchive.cpp \
+    src/Data/PdfMerger.cpp \
     src/Widgets/SettingsW.cpp \
     src/Widgets/RichTextEditW.cpp \
     src/Data/DocumentElements.cpp \
@@ -55,9 +66,13 @@ HEADERS += \
 #    include/thirdparty/asyncfuture/asyncfuture.h \
 #    include/Workers/ImageReader.hpp \
     include/UI/UIElements.hpp \
+    include/UI/PhotosListModel.hpp \
     include/Workers/PDFGeneratorWorker.hpp \
     include/Utility.hpp \
     include/Workers/PhotoLoaderWorker.hpp \
+    include/Workers/FilePrefetcher.hpp \
+    include/Workers/DirectoryScannerWorker.hpp \
+    include/Workers/WorkSaverWorker.hpp \
     include/Widgets/PreviewW.hpp \
     include/Widgets/PhotoW.hpp \
     include/Widgets/CustomPageW.hpp \
@@ -67,6 +82,11 @@ HEADERS += \
     include/Widgets/PageW.hpp \
     include/Widgets/SettingsW.hpp \
     include/Data/Photo.hpp \
+    include/Data/ExifReader.hpp \
+    include/Data/PhotoMetadata.hpp \
+    include/Data/ResourceStore.hpp \
+    include/Data/WorkArchive.hpp \
+    include/Data/PdfMerger.hpp \
     include/Data/RectPageItem.hpp \
     include/Widgets/SetStyleW.hpp \
     include/Widgets/RichTextEditW.hpp \
@@ -80,6 +100,9 @@ HEADERS += \
     include/Widgets/PageSetsW.hpp \
     include/Widgets/RightSettingsW.hpp \
     include/DebugMessage.hpp \
+    include/Trace.hpp \
+    include/Counters.hpp \
+    include/Widgets/DiagnosticsW.hpp \
     include/Widgets/MiscW.hpp \
     include/Widgets/DegradedW.hpp \
     include/Widgets/ImagePositionW.hpp \
@@ -0,0 +1,106 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file Counters.hpp
+ * \brief defines Counters
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QElapsedTimer>
+
+// std
+#include <atomic>
+
+namespace pc
+{
+    enum class Counter : int {
+        // last preview, by stage (us)
+        PreviewPagesUs=0, PreviewLayoutUs, PreviewDrawUs, PreviewDisplayUs, PreviewLatencyUs, PreviewTilesUs,
+        // photos loader
+        DecodeQueue, PrefetchHits, PrefetchMisses, PrefetchWaitUs, PrefetchBytes,
+        // caches
+        PageThumbnailsHits, PageThumbnailsMisses, PhotoIconsHits, PhotoIconsMisses, ResourceKeysHits, ResourceKeysMisses,
+        BackgroundLayersHits, BackgroundLayersMisses, TextLayoutsHits, TextLayoutsMisses, ExportedPagesHits, ExportedPagesMisses,
+        // memory (bytes)
+        PdfResourcesBytes, PhotosBytes,
+        // workers busy time (us)
+        PhotoLoaderBusyUs, PdfGeneratorBusyUs, PageThumbnailsBusyUs, WorkSaverBusyUs,
+        SizeEnum
+    };
+
+    /**
+     * @brief Registry of the diagnostics counters, updated from any thread with relaxed atomics
+     */
+    struct Counters{
+
+        static void set(Counter counter, qint64 value) noexcept{
+            values()[static_cast<int>(counter)].store(value, std::memory_order_relaxed);
+        }
+
+        static void add(Counter counter, qint64 value = 1) noexcept{
+            values()[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        static qint64 get(Counter counter) noexcept{
+            return values()[static_cast<int>(counter)].load(std::memory_order_relaxed);
+        }
+
+        static void hit(Counter hits, Counter misses, bool found) noexcept{
+            add(found ? hits : misses);
+        }
+
+    private:
+
+        static std::atomic<qint64> *values() noexcept{
+            static std::atomic<qint64> counters[static_cast<int>(Counter::SizeEnum)];
+            return counters;
+        }
+    };
+
+    /**
+     * @brief Add the time spent in a scope to a busy time counter
+     */
+    struct BusyScope{
+
+        BusyScope(Counter counter) : m_counter(counter){
+            m_timer.start();
+        }
+
+        ~BusyScope(){
+            Counters::add(m_counter, m_timer.nsecsElapsed()/1000);
+        }
+
+    private:
+
+        Counter m_counter;
+        QElapsedTimer m_timer;
+    };
+}
@@ -52,6 +52,7 @@ namespace pc {
 
     struct PCPage;
     using SPCPage = std::shared_ptr<PCPage>;
+    using SCPCPage = std::shared_ptr<const PCPage>;
 
     struct PCPages;
     using SPCPages = std::shared_ptr<PCPages>;
@@ -68,7 +69,7 @@ namespace pc {
     struct Header : public RectPageItem {
 
         // settings
-        HeaderSettings settings;
+        SHeaderSettings settings = nullptr;
 
         // sizes
         void compute_sizes(QRectF upperRect);
@@ -77,7 +78,7 @@ namespace pc {
     struct Footer : public RectPageItem {
 
         // settings
-        FooterSettings settings;
+        SFooterSettings settings = nullptr;
 
         // sizes
         void compute_sizes(QRectF upperRect){
@@ -88,7 +89,7 @@ namespace pc {
     struct PCSet : public RectPageItem{
 
         // settings
-        SetSettings settings;
+        SSetSettings settings = nullptr;
 
         // current
         int id;         /**< id of the set in its page */
@@ -96,18 +97,20 @@ namespace pc {
 
         // sub elements
         // # photo
-        SPhoto photo = nullptr;
+        SCPhoto photo  = nullptr;   /**< copy of the photo version drawn by the workers */
+        SPhoto source  = nullptr;   /**< photo of the UI the copy comes from */
         // # text
         SConsign text = nullptr;
 
         // sizes
+        QRectF photoRect; /**< the photo is shared by all the versions of the document, its rect is kept here */
         void compute_sizes(QRectF upperRect);
     };
 
     struct PCPage : public RectPageItem{
 
         // settings
-        PageSettings settings;
+        SPageSettings settings = nullptr;
 
         // current
         int id;
@@ -127,26 +130,30 @@ namespace pc {
         QRectF setsRect;
         QRectF pageMinusMarginsRect;
         QVector<QRectF> interMarginsRects;
-        void compute_sizes(QRectF upperRect);                
+        void compute_sizes(QRectF upperRect);
+
+        /**
+         * @brief Return a copy of the page with the sizes of its elements computed for pageRect, settings and photos are shared with the copy.
+         * The page itself is never modified, so it can be shared between the versions of the document and the threads.
+         */
+        SPCPage layout(const QRectF &pageRect) const;
     };
 
+    /**
+     * @brief Version of the document sent to the workers, its pages are immutable and shared with the previous versions when unchanged.
+     */
     struct PCPages{
 
         // settings
         DocumentSettings settings;
 
         // current
+        quint64 version = 0;
         QString pdfFileName = "";
 
         // sub elemetns
         // # pages
-        QVector<SPCPage> pages;
-
-        // sizes
-        void compute_all_pages_sizes(int width, int height){
-            for(auto &&page : pages)
-                page->compute_sizes(QRectF(0,0,width,height));
-        }
+        QVector<SCPCPage> pages;
 
         // others
         ~PCPages(){
@@ -156,5 +163,11 @@ namespace pc {
         int page_photos_number(int index) const{
             return pages[index]->sets.size();
         }
+
+        /**
+         * @brief Return a hash of what is drawn on the page at index. Shared settings are immutable and identified by their uid,
+         * photos by their path, rotation and thumbnail.
+         */
+        uint page_hash(int index) const;
     };
 }
@@ -0,0 +1,113 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file ExifReader.hpp
+ * \brief defines ExifReader
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QImage>
+#include <QByteArray>
+#include <QString>
+
+// local
+#include "PhotoMetadata.hpp"
+
+namespace pc {
+
+    /**
+     * @brief Read the EXIF data of the photos files without decoding their main image.
+     */
+    class ExifReader{
+
+    public:
+
+        /**
+         * @brief Return the TIFF data of the APP1 EXIF segment of a jpeg file, only the markers before the segment are read.
+         * @param [in] maxSize if > 0, only the first maxSize bytes of the segment are read
+         * @return empty array if the file has no EXIF segment
+         */
+        static QByteArray read_jpeg_exif_data(const QString &path, int maxSize = -1);
+
+        /**
+         * @brief Return the first bytes of a TIFF file, which usually contain its first IFD
+         */
+        static QByteArray read_tiff_data(const QString &path, int maxSize);
+
+        /**
+         * @brief Read capture time, orientation, dimensions and camera from the EXIF/TIFF headers of a jpeg or a tiff file.
+         * Only a few KB of the file are read.
+         */
+        static PhotoMetadata read_metadata(const QString &path);
+
+        /**
+         * @brief Return the thumbnail embedded by the camera in the IFD1 of the EXIF data (usually 160x120)
+         * @return null image if there is no thumbnail
+         */
+        static QImage read_embedded_thumbnail(const QString &path);
+
+    private:
+
+        struct TiffData{
+
+            TiffData(const QByteArray &data);
+
+            bool valid() const noexcept {return m_valid;}
+
+            quint16 u16(int offset) const;
+            quint32 u32(int offset) const;
+
+            quint32 first_ifd_offset() const {return u32(4);}
+            quint32 next_ifd_offset(quint32 ifdOffset) const;
+
+            /**
+             * @brief Look for a tag in the IFD starting at ifdOffset and return the offset of its 12 bytes entry, -1 if not found
+             */
+            int find_entry(quint32 ifdOffset, quint16 tag) const;
+
+            /**
+             * @brief Return the value of a SHORT or LONG entry
+             */
+            quint32 uint_value(int entry) const;
+
+            /**
+             * @brief Return the value of an ASCII entry without its ending null character
+             */
+            QByteArray ascii_value(int entry) const;
+
+            const QByteArray &data;
+
+        private:
+            bool m_valid = false;
+            bool m_littleEndian = true;
+        };
+    };
+}
@@ -0,0 +1,56 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+#pragma once
+
+/**
+ * \file PdfMerger.hpp
+ * \brief defines PdfMerger
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QStringList>
+
+namespace pc {
+
+    /**
+     * @brief Concatenate the pages of PDF files written by Qt without drawing them again.
+     * The objects of each file are copied with new numbers and its pages attached to a single pages tree,
+     * only the classic cross-reference tables written by the Qt PDF engine are supported (no object streams).
+     */
+    class PdfMerger{
+
+    public:
+
+        /**
+         * @brief Write the pages of the files in the given order into the output file, replaced only at the end
+         */
+        static bool merge(const QStringList &files, const QString &outputPath);
+    };
+}
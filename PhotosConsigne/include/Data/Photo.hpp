@@ -40,6 +40,7 @@
 
 // Qt
 #include <QImage>
+#include <QImageIOHandler>
 #include <QFileInfo>
 #include <QPainter>
 
@@ -47,6 +48,7 @@
 #include "RectPageItem.hpp"
 #include "PaperFormat.hpp"
 #include "DebugMessage.hpp"
+#include "Counters.hpp"
 
 
 namespace pc
@@ -54,10 +56,43 @@ namespace pc
     // define aliases
     struct Photo;
     using SPhoto  = std::shared_ptr<Photo>;
+    using SCPhoto = std::shared_ptr<const Photo>;
 
     using Photos  = QList<SPhoto>;
     using SPhotos = std::shared_ptr<Photos>;
 
+    /**
+     * @brief Photo scaled and cropped for its rectangle, can be computed in any thread before being drawn
+     */
+    struct PreparedPhoto{
+        QImage image;
+        QRectF rect;
+    };
+
+
+    /**
+     * @brief Bytes of a thumbnail kept in the PhotosBytes counter, the copies of a photo share its image and are not counted
+     */
+    struct ThumbnailBytes{
+
+        ThumbnailBytes() = default;
+        ThumbnailBytes(const ThumbnailBytes &) noexcept{}
+        ThumbnailBytes(ThumbnailBytes &&other) noexcept : bytes(other.bytes){other.bytes = 0;}
+        ThumbnailBytes &operator=(const ThumbnailBytes &) noexcept{return *this;}
+
+        ~ThumbnailBytes(){
+            Counters::add(Counter::PhotosBytes, -bytes);
+        }
+
+        void update(const QImage &image) noexcept{
+            qint64 newBytes = static_cast<qint64>(image.bytesPerLine()) * image.height();
+            Counters::add(Counter::PhotosBytes, newBytes - bytes);
+            bytes = newBytes;
+        }
+
+        qint64 bytes = 0;
+    };
+
 
     struct Photo : public RectPageItem {
 
@@ -65,9 +100,71 @@ namespace pc
 
         Photo(const Photo &photo) = default;
 
+        Photo(Photo &&photo) = default;
+
         Photo(QImage image);
 
-        Photo(const QString &path, bool isWhiteSpace = false);
+        /**
+         * @brief Photo constructor
+         * @param [in] path of the photo file
+         * @param [in] isWhiteSpace
+         * @param [in] loadThumbnail if false, only the header of the file is read (size, format, orientation),
+         * the thumbnail must then be decoded later with read_thumbnail and given with set_thumbnail
+         */
+        Photo(const QString &path, bool isWhiteSpace = false, bool loadThumbnail = true);
+
+        /**
+         * @brief Photo constructor from an already read header (e.g. from a work archive), the file is not accessed
+         * and the thumbnail must be given with set_thumbnail
+         */
+        Photo(const QString &path, QSize originalSize, QByteArray format, QImageIOHandler::Transformations transformation);
+
+        /**
+         * @brief Decode the photo file directly at the thumbnail size (thumbnailMaxWidth x thumbnailMaxHeight),
+         * the reader handler downscales during the decoding when the format allows it (jpeg)
+         */
+        static QImage read_thumbnail(const QString &path);
+
+        /**
+         * @brief Same as above from the file content already read in memory, the path is used if the data is empty
+         */
+        static QImage read_thumbnail(const QString &path, const QByteArray &data);
+
+        /**
+         * @brief Read the small thumbnail embedded in the EXIF data of the file without decoding the photo, cropped to the ratio of originalSize
+         */
+        static QImage read_embedded_thumbnail(const QString &path, const QSize &originalSize);
+
+        /**
+         * @brief Define the decoded thumbnail of the photo, the current rotation is applied on it
+         */
+        void set_thumbnail(QImage thumbnail);
+
+        /**
+         * @brief Define the metadata read from the EXIF headers
+         * @param [in] applyOrientation if true, the rotation of the photo is initialized from the EXIF orientation
+         */
+        void set_metadata(PhotoMetadata photoMetadata, bool applyOrientation);
+
+        /**
+         * @brief Read again the header of the modified file, the thumbnail must then be decoded again
+         */
+        void reload_header();
+
+        /**
+         * @brief Rotate the photo and its thumbnail by a multiple of 90 degrees
+         */
+        void rotate(int angle);
+
+        /**
+         * @brief Return an immutable copy of the photo for the document snapshots, the workers draw it while the UI modifies the original
+         */
+        SCPhoto snapshot() const;
+
+        /**
+         * @brief Return a new photo identifier, never reused
+         */
+        static quint64 new_uid();
 
         void compute_sizes(QRectF upperRect){
             rectOnPage = std::move(upperRect);
@@ -75,13 +172,25 @@ namespace pc
 
         QSize size() const noexcept {return originalSize;}
 
-        QSize scaled_size() const noexcept {return scaledPhoto.size();}
+        /**
+         * @brief Return the size of the thumbnail, if it's not decoded yet the size is deduced from the original one
+         */
+        QSize scaled_size() const noexcept;
 
-        void draw(QPainter &painter, const ImagePositionSettings &position,  const QRectF &rectPhoto, const ExtraPCInfo &infos, const QSizeF &pageSize = QSizeF());
+        void draw(QPainter &painter, const ImagePositionSettings &position,  const QRectF &rectPhoto, const ExtraPCInfo &infos, const QSizeF &pageSize = QSizeF()) const;
+
+        /**
+         * @brief Scale the thumbnail (or its placeholder) of the preview for the given rectangle without drawing it, the result is drawn with draw_prepared
+         */
+        PreparedPhoto prepare_preview(const ImagePositionSettings &position, const QRectF &rectPhoto, const ExtraPCInfo &infos) const;
+
+        void draw_prepared(QPainter &painter, const PreparedPhoto &prepared, const ExtraPCInfo &infos, const QSizeF &pageSize) const;
 
     private:
 
-        QRectF draw_small(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos, const QSizeF &pageSize);
+        QRectF draw_small(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos, const QSizeF &pageSize) const;
+
+        PreparedPhoto prepare_small(const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos) const;
 
         void draw_huge_photo_whith_tiles(QPainter &painter, const QImage &photoToUpscale, const QRectF &rectPhoto);
 
@@ -89,20 +198,31 @@ namespace pc
 
     public:
 
+        static constexpr int thumbnailMaxWidth  = 800;
+        static constexpr int thumbnailMaxHeight = 800;
+
         bool isWhiteSpace = false;
         bool isADuplicate = false;
         bool isRemoved    = false;
         bool isOnDocument = false;
+        bool isLoaded     = false; /**< is the thumbnail decoded, if not scaledPhoto can contain the embedded EXIF thumbnail */
 
         int rotation = 0;
         int loadedId = 0;  // global id from all loaded photos
         int id       = -1; // id from all valid photos
         int pageId   = -1;
+        quint64 version = 0; /**< incremented when the drawn state (thumbnail, rotation, header) changes */
+        quint64 uid = new_uid(); /**< kept by the copies of the photo (snapshots, reloads), new for the duplicates */
 
         QSize originalSize;
+        QByteArray format;
+        QImageIOHandler::Transformations transformation = QImageIOHandler::TransformationNone;
         QString pathPhoto;
         QString namePhoto;
         QFileInfo info;
+        QDateTime lastModified; /**< modification date of the file, read at the import and at the reload */
         QImage scaledPhoto;
+        ThumbnailBytes thumbnailBytes; /**< must be updated after each modification of scaledPhoto */
+        PhotoMetadata metadata;
     };
 }
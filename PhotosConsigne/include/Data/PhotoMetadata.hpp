@@ -0,0 +1,117 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file PhotoMetadata.hpp
+ * \brief defines PhotoMetadata/MetadataIndex
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QDateTime>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QReadWriteLock>
+
+namespace pc {
+
+    /**
+     * @brief Informations read from the EXIF/TIFF headers of a photo file
+     */
+    struct PhotoMetadata{
+
+        bool valid = false; /**< EXIF or TIFF headers found */
+
+        QDateTime captureTime;  /**< DateTimeOriginal, DateTime if missing */
+        int orientation = 1;    /**< EXIF orientation (1-8) */
+        QSize dimensions;       /**< size of the main image declared by the headers */
+        QString cameraMake;
+        QString cameraModel;
+
+        /**
+         * @brief Return the rotation in degrees to apply to display the photo upright (mirroring is ignored)
+         */
+        int rotation() const noexcept{
+            switch(orientation){
+            case 3: case 4:
+                return 180;
+            case 5: case 6:
+                return 90;
+            case 7: case 8:
+                return 270;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Return the camera name as displayed to the user
+         */
+        QString camera() const{
+            if(cameraModel.startsWith(cameraMake, Qt::CaseInsensitive)){
+                return cameraModel;
+            }
+            return (cameraMake + " " + cameraModel).trimmed();
+        }
+    };
+
+    /**
+     * @brief In-memory index of the metadata of the photos files, filled in parallel.
+     */
+    class MetadataIndex{
+
+    public:
+
+        /**
+         * @brief Read in parallel the metadata of the files not already indexed, block until done
+         */
+        static void index(const QStringList &paths);
+
+        /**
+         * @brief Read again in parallel the metadata of the files, even if already indexed (e.g. modified files)
+         */
+        static void reindex(const QStringList &paths);
+
+        /**
+         * @brief Return the indexed metadata of a file, read it if not indexed yet
+         */
+        static PhotoMetadata get(const QString &path);
+
+        /**
+         * @brief Remove all the indexed metadata
+         */
+        static void clear();
+
+    private:
+
+        static QReadWriteLock m_locker;
+        static QHash<QString, PhotoMetadata> m_metadata;
+    };
+}
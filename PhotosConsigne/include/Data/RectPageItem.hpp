@@ -39,13 +39,17 @@
 
 // local
 #include "PaperFormat.hpp"
+#include "PhotoMetadata.hpp"
 
 // Qt
 #include <QRectF>
-#include <QFileInfo>
+#include <QDateTime>
 #include <QColor>
 #include <QVector>
 
+// std
+#include <atomic>
+
 namespace pc {
 
     // define enums
@@ -100,7 +104,23 @@ namespace pc {
 
 
     struct Settings{
+
+        Settings() : uid(next_uid()){}
+        Settings(const Settings &) : uid(next_uid()){}
+        Settings &operator=(const Settings &){
+            uid = next_uid();
+            return *this;
+        }
         virtual ~Settings(){}
+
+        quint64 uid; /**< new for each created or modified settings, unlike the addresses it is never reused */
+
+    private:
+
+        static quint64 next_uid(){
+            static std::atomic<quint64> counter{0};
+            return ++counter;
+        }
     };
 
     struct ImagePositionSettings : public Settings{
@@ -110,11 +130,17 @@ namespace pc {
         qreal scale = 1.;
         PhotoPosition alignment = PhotoPosition::middle_center;
         PhotoAdjust adjustment = PhotoAdjust::adjust;
+
+        bool operator==(const ImagePositionSettings &other) const noexcept{
+            return xPos == other.xPos && yPos == other.yPos && scale == other.scale &&
+                   alignment == other.alignment && adjustment == other.adjustment;
+        }
     };
 
     struct ExtraPCInfo{
 
-        QFileInfo fileInfo;
+        QDateTime fileDate; /**< modification date of the photo file, read when the photo is imported or reloaded */
+        PhotoMetadata photoMetadata;
         QString namePCAssociatedPhoto = "";
         QString pageName;
 
@@ -0,0 +1,89 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file ResourceStore.hpp
+ * \brief defines ResourceStore
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QImage>
+#include <QString>
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+
+namespace pc {
+
+    /**
+     * @brief Content-addressed storage of the rich text images of a work, each image is written once in the resources directory
+     * under the hash of its content and never re-encoded while its content does not change. Thread safe, works are saved in background.
+     */
+    class ResourceStore{
+
+    public:
+
+        /**
+         * @brief Return the hash of the image content, memorized for the image data (QImage::cacheKey)
+         */
+        QString content_key(const QImage &image);
+
+        /**
+         * @brief Write the image in the directory if no file with the same content exists, return its path (empty if failure)
+         */
+        QString store(const QString &dirPath, const QImage &image);
+
+        /**
+         * @brief Return the PNG encoding of the image, encoded only once per content
+         */
+        QByteArray png_data(const QImage &image);
+
+        /**
+         * @brief Memorize the content key of an image loaded from the store
+         */
+        void register_resource(const QImage &image, const QString &path);
+
+        /**
+         * @brief Memorize the content key and the PNG encoding of an image loaded from a work archive
+         */
+        void register_content(const QImage &image, const QString &contentKey, const QByteArray &pngData);
+
+        /**
+         * @brief Remove the images of the directory not in the given files names, return the number of removed files
+         */
+        static int collect_garbage(const QString &dirPath, const QSet<QString> &usedFilesNames);
+
+    private:
+
+        QMutex m_locker;
+        QHash<qint64, QString> m_keys;       /**< content keys by cache key */
+        QHash<QString, QByteArray> m_pngData; /**< PNG encodings by content key */
+    };
+}
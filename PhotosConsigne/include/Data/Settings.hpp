@@ -58,6 +58,13 @@ namespace pc {
         qreal interHeight;
         qreal footer;
         qreal header;
+
+        bool operator==(const MarginsSettings &other) const noexcept{
+            return exteriorMarginsEnabled == other.exteriorMarginsEnabled && interiorMarginsEnabled == other.interiorMarginsEnabled &&
+                   footerHeaderMarginEnabled == other.footerHeaderMarginEnabled &&
+                   left == other.left && right == other.right && top == other.top && bottom == other.bottom &&
+                   interWidth == other.interWidth && interHeight == other.interHeight && footer == other.footer && header == other.header;
+        }
     };
 
     struct BordersSettings  : public Settings{
@@ -70,12 +77,21 @@ namespace pc {
         bool between = false;
         qreal width = 1.;
         QPen pen;
+
+        bool operator==(const BordersSettings &other) const noexcept{
+            return display == other.display && left == other.left && top == other.top && right == other.right &&
+                   bottom == other.bottom && between == other.between && width == other.width && pen == other.pen;
+        }
     };
 
     struct MiscSettings : public Settings{
 
         bool doNotDisplayHeader;
         bool doNotDisplayFooter;
+
+        bool operator==(const MiscSettings &other) const noexcept{
+            return doNotDisplayHeader == other.doNotDisplayHeader && doNotDisplayFooter == other.doNotDisplayFooter;
+        }
     };
 
     struct SetsPositionSettings  : public Settings{
@@ -90,6 +106,11 @@ namespace pc {
         QVector<qreal> linesHeight;
 
         QVector<QRectF> relativePosCustom;
+
+        bool operator==(const SetsPositionSettings &other) const noexcept{
+            return customMode == other.customMode && nbPhotos == other.nbPhotos && nbPhotosH == other.nbPhotosH && nbPhotosV == other.nbPhotosV &&
+                   columnsWidth == other.columnsWidth && linesHeight == other.linesHeight && relativePosCustom == other.relativePosCustom;
+        }
     };
 
     struct ColorsSettings  : public Settings{
@@ -102,6 +123,11 @@ namespace pc {
         QPointF start;
         QPointF end;
         DegradedType degradedType;
+
+        bool operator==(const ColorsSettings &other) const noexcept{
+            return type == other.type && color1 == other.color1 && color2 == other.color2 &&
+                   start == other.start && end == other.end && degradedType == other.degradedType;
+        }
     };
 
     struct BackGroundSettings  : public Settings{
@@ -110,6 +136,10 @@ namespace pc {
         ImagePositionSettings imagePosition;
         ColorsSettings colors;
         SPhoto photo = nullptr;
+
+        bool operator==(const BackGroundSettings &other) const noexcept{
+            return displayPhoto == other.displayPhoto && imagePosition == other.imagePosition && colors == other.colors && photo == other.photo;
+        }
     };
 
     struct StyleSettings  : public Settings{
@@ -117,6 +147,10 @@ namespace pc {
         ImagePositionSettings imagePosition;
         qreal ratioTextPhoto;
         Position textPositionFromPhotos;
+
+        bool operator==(const StyleSettings &other) const noexcept{
+            return imagePosition == other.imagePosition && ratioTextPhoto == other.ratioTextPhoto && textPositionFromPhotos == other.textPositionFromPhotos;
+        }
     };
 
     struct PhotosSettings  : public Settings{
@@ -129,6 +163,11 @@ namespace pc {
 
     struct TextSettings  : public Settings{
         std::shared_ptr<QString> html = nullptr;
+
+        // a new html string is allocated at each modification of the text
+        bool operator==(const TextSettings &other) const noexcept{
+            return html == other.html;
+        }
     };
 
     struct HeaderSettings  : public Settings{
@@ -137,6 +176,10 @@ namespace pc {
         qreal ratio;
         BackGroundSettings background;
         TextSettings text;
+
+        bool operator==(const HeaderSettings &other) const noexcept{
+            return enabled == other.enabled && ratio == other.ratio && background == other.background && text == other.text;
+        }
     };
 
     struct FooterSettings : public Settings{
@@ -145,6 +188,10 @@ namespace pc {
         qreal ratio;
         BackGroundSettings background;
         TextSettings text;
+
+        bool operator==(const FooterSettings &other) const noexcept{
+            return enabled == other.enabled && ratio == other.ratio && background == other.background && text == other.text;
+        }
     };
 
     struct SetSettings : public Settings{
@@ -155,6 +202,11 @@ namespace pc {
         StyleSettings style;
         BordersSettings borders;
         TextSettings text;
+
+        // the current ids are selection states of the ui, not used for drawing
+        bool operator==(const SetSettings &other) const noexcept{
+            return style == other.style && borders == other.borders && text == other.text;
+        }
     };
 
     struct PageSettings  : public Settings{
@@ -167,8 +219,31 @@ namespace pc {
         BackGroundSettings background;
         SetsPositionSettings positions;
         MiscSettings misc;        
+
+        // the current id and the number of pages are states of the document, not of the page
+        bool operator==(const PageSettings &other) const noexcept{
+            return name == other.name && margins == other.margins && background == other.background &&
+                   positions == other.positions && misc == other.misc;
+        }
     };
 
+    // immutable settings shared between the document elements
+    using SHeaderSettings   = std::shared_ptr<const HeaderSettings>;
+    using SFooterSettings   = std::shared_ptr<const FooterSettings>;
+    using SSetSettings      = std::shared_ptr<const SetSettings>;
+    using SPageSettings     = std::shared_ptr<const PageSettings>;
+
+    /**
+     * @brief Return the current shared settings if their values are the same than the given ones, a new shared copy otherwise
+     */
+    template<typename T>
+    std::shared_ptr<const T> share_settings(const std::shared_ptr<const T> &current, const T &settings){
+        if(current != nullptr && *current == settings){
+            return current;
+        }
+        return std::make_shared<const T>(settings);
+    }
+
     struct DocumentSettings : public Settings{
 
         bool grayScale           = false;
@@ -0,0 +1,87 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file WorkArchive.hpp
+ * \brief defines WorkArchive/WorkArchiveContent
+ * \date 19/10/2026
+ */
+
+// local
+#include "Photo.hpp"
+
+// Qt
+#include <QUrl>
+
+namespace pc {
+
+    /**
+     * @brief Content of a binary work
+     */
+    struct WorkArchiveContent{
+
+        QByteArray settings;                /**< xml of the document settings, only the individual sets overrides */
+        SPhotos photos = nullptr;           /**< photos with their headers and placeholders thumbnails */
+
+        QVector<QUrl> resourcesUrl;         /**< rich text images */
+        QVector<QString> resourcesKey;      /**< content keys of the images (see ResourceStore) */
+        QVector<QByteArray> resourcesData;  /**< PNG encodings of the images */
+        QVector<QImage> resourcesImages;    /**< decoded images, filled only when loading */
+    };
+
+    /**
+     * @brief Binary container of a work (*.pcwork): a versioned settings section, the photos headers, their thumbnails and the resources.
+     * Each section is addressed by its offset, the file is memory-mapped when loading so no photo file is accessed.
+     */
+    class WorkArchive{
+
+    public:
+
+        static constexpr quint32 magic         = 0x50435741; // PCWA
+        static constexpr quint32 formatVersion = 1;
+        static constexpr int thumbnailSize     = 256;        /**< placeholders max size, the full thumbnails are decoded afterwards */
+
+        enum class Section : quint32 {Settings = 0, Photos, Thumbnails, Resources};
+
+        /**
+         * @brief Return true if the file starts with the archive magic number
+         */
+        static bool is_archive(const QString &path);
+
+        static bool save(const QString &path, const WorkArchiveContent &content);
+
+        static bool load(const QString &path, WorkArchiveContent &content);
+
+    private:
+
+        static QByteArray encode_thumbnail(const SPhoto &photo);
+
+        static QImage decode_thumbnail(const QByteArray &data);
+    };
+}
@@ -37,6 +37,7 @@
 #include <QDebug>
 #include <QString>
 #include <QElapsedTimer>
+#include <QTextStream>
 
 namespace pc
 {
@@ -55,4 +56,61 @@ namespace pc
         QElapsedTimer timer;
 
     };
+
+    /**
+     * @brief Print a benchmark result on the standard output, apart from the debug messages
+     */
+    inline void benchmark_report(const QString &result){
+        QTextStream out(stdout);
+        out << result << endl;
+    }
+
+    /**
+     * @brief Time the startup steps, from the application creation to the first event loop iteration,
+     * only when the PHOTOSCONSIGNE_STARTUP environment variable is set
+     */
+    struct StartupProfiler{
+
+        static void start(){
+            if(qgetenv("PHOTOSCONSIGNE_STARTUP").isEmpty()){
+                return;
+            }
+            timer().start();
+            last() = 0;
+        }
+
+        static void step(const QString &component){
+
+            if(!timer().isValid()){
+                return;
+            }
+
+            qint64 current = timer().elapsed();
+            qDebug() << "-Startup:" << component << current - last() << "ms";
+            last() = current;
+        }
+
+        static void end(const QString &component){
+
+            if(!timer().isValid()){
+                return;
+            }
+
+            step(component);
+            qDebug() << "-Startup: total" << timer().elapsed() << "ms";
+            timer().invalidate();
+        }
+
+    private:
+
+        static QElapsedTimer &timer(){
+            static QElapsedTimer startupTimer;
+            return startupTimer;
+        }
+
+        static qint64 &last(){
+            static qint64 lastStep = 0;
+            return lastStep;
+        }
+    };
 }
@@ -0,0 +1,88 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file Trace.hpp
+ * \brief defines Trace
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QString>
+
+namespace pc
+{
+    /**
+     * @brief Record timed spans from any thread and write them as a Chrome trace-event JSON file.
+     * Enabled by setting the PHOTOSCONSIGNE_TRACE environment variable to the output file path,
+     * the trace can then be opened in chrome://tracing or Perfetto.
+     */
+    class Trace{
+
+    public:
+
+        static bool enabled() noexcept;
+
+        static qint64 now_us();
+
+        static void add_span(const char *name, qint64 startUs, qint64 durationUs);
+
+        /**
+         * @brief Write the recorded spans in the file given by the environment variable, do nothing if disabled
+         */
+        static void write();
+    };
+
+    /**
+     * @brief Record a span from its construction to its destruction, only a boolean test when tracing is disabled
+     * @param name must be a string literal
+     */
+    struct TraceSpan{
+
+        TraceSpan(const char *name) : m_name(name){
+            if(Trace::enabled()){
+                m_start = Trace::now_us();
+            }
+        }
+
+        ~TraceSpan(){
+            if(m_start >= 0){
+                Trace::add_span(m_name, m_start, Trace::now_us() - m_start);
+            }
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+
+        const char *m_name;
+        qint64 m_start = -1;
+    };
+}
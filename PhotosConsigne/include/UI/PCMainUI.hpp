@@ -38,11 +38,17 @@
 #include <QThread>
 #include <QTime>
 #include <QTimer>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
 
 // # workers
 #include "PhotoLoaderWorker.hpp"
 #include "PDFGeneratorWorker.hpp"
 #include "UIElements.hpp"
+#include "ResourceStore.hpp"
+#include "WorkArchive.hpp"
+#include "WorkSaverWorker.hpp"
+#include "DirectoryScannerWorker.hpp"
 
 
 namespace pc {
@@ -74,6 +80,28 @@ public slots:
 
     // actions
     void add_photos_directory();
+
+    /**
+     * @brief Start or stop the watch of the last added directory (hot folder), its new photos are appended as they arrive
+     */
+    void watch_photos_directory(bool watch);
+
+    /**
+     * @brief Read again the photos modified in the watched directory and draw their pages again
+     */
+    void reload_modified_photos(QStringList photosPath);
+
+    /**
+     * @brief Replace the photos by their copies reloaded by the loader, the changes made in the UI meanwhile are kept
+     */
+    void replace_reloaded_photos(SPhotos photos);
+
+    /**
+     * @brief Export again the last generated PDF if asked in hot folder mode, only the modified pages are rendered
+     */
+    void update_exported_pdf();
+
+    void display_diagnostics_window();
     void load_new_photos();
     void remove_all_photos();
     void insert_transparent_space();
@@ -92,12 +120,38 @@ public slots:
     void build_valid_sets();
     void build_pages();
 
+    /**
+     * @brief Log the median time of build_pages for a growing number of photos (full rebuild and incremental updates)
+     */
+    void benchmark_build_pages();
+
     // preview
     void update_settings_with_no_preview();
     void update_settings();
 
+    // work
+    void add_work_resource(QUrl url, QImage image);
+    /**
+     * @brief Take a snapshot of the work and send it to the saver worker, xml work or binary container (*.pcwork) depending on the extension
+     */
+    void save_work(const QString &filePath);
+    void load_work_archive(const QString &filePath);
+    /**
+     * @brief Add the photos read by the loader and load the settings of the xml work file
+     */
+    void end_loading_work(SPhotos photos);
+
 private :
 
+    // preview
+    void ask_for_preview_generation(bool drawZones);
+
+    // thumbnails
+    void prioritize_thumbnails_decoding();
+
+    // pages list
+    void request_pages_thumbnails();
+
     // conections
     void from_main_UI_connections();
     void from_main_module_connections();
@@ -110,21 +164,44 @@ signals :
     void init_document_signal();
     void start_loading_photos_signal(QStringList photosPath, int startIdToInsert);
     void stop_loading_photos_signal();
-    void start_preview_generation_signal(PCPages pcPages, int idPageToDraw, bool drawZones);
+    void scan_photos_directory_signal(QString directory, bool recursive);
+    void watch_photos_directory_signal(QString directory, bool recursive);
+    void stop_watching_photos_directory_signal();
+    void start_saving_work_signal(WorkSnapshot snapshot);
+    void decode_thumbnails_signal(SPhotos photos);
+    void reload_photos_signal(SPhotos photos);
+    void load_work_photos_signal(QVector<QXmlStreamAttributes> photosAttributes);
+    void prioritize_photos_signal(SPhotos photos);
+    void start_preview_generation_signal(PCPages pcPages, int idPageToDraw, bool drawZones, QSize targetSize);
     void start_PDF_generation_signal(PCPages pcPages);
+    void start_pages_thumbnails_generation_signal(PCPages pcPages, QVector<int> pagesId, QVector<uint> pagesHash);
     void kill_signal();
     void select_pc_signal(int idPC);
 
 private:
 
     bool m_isLoadingPhotos      = false;
+    bool m_isGeneratingPDF      = false;
+    bool m_exportAgain          = false;
+    bool m_scannedRecursive     = false;
+    QString m_workFilePath;             /**< xml work file being loaded */
+    QString m_scannedDirectory;         /**< last directory added, watched in hot folder mode */
+    QString m_previousDirectory;        /**< directory added before the scanned one, restored if no photo is found */
     bool m_isPreviewComputing   = false;
     bool m_generatePreviewAgain = false;
     QReadWriteLock m_previewLocker;    
+    QElapsedTimer m_previewTimer;       /**< time since the last preview request */
+    QTimer m_thumbnailsTimer;           /**< coalesces the pages rebuilds after the decoded thumbnails */
+    bool m_previewThumbnailDecoded = false;
     QString m_version;
 
     PCPages m_pcPages;                  /**< document pages to be drawn */
+    SSetSettings m_sharedSetsSettings       = nullptr; /**< global sets settings shared by the non individual sets */
+    SPageSettings m_sharedPagesSettings     = nullptr; /**< global pages settings shared by the non individual pages */
+    SHeaderSettings m_sharedHeaderSettings  = nullptr;
+    SFooterSettings m_sharedFooterSettings  = nullptr;
     GlobalSettings m_settings;  /**< global parameters of the document */
+    ResourceStore m_resourceStore;  /**< rich text images saved with the works */
 
     // ui
     UIElements m_ui; /**< dynamic ui elements */
@@ -132,9 +209,18 @@ private:
     // threads
     std::unique_ptr<PhotoLoaderWorker> m_loadPhotoWorker = nullptr;
     std::unique_ptr<PDFGeneratorWorker> m_pdfGeneratorWorker = nullptr;
+    std::unique_ptr<PDFGeneratorWorker> m_pageThumbnailsWorker = nullptr; /**< renders the pages list thumbnails */
+    std::unique_ptr<WorkSaverWorker> m_workSaverWorker = nullptr;
+    std::unique_ptr<DirectoryScannerWorker> m_directoryScannerWorker = nullptr;
+
+    // photo display
+    QFutureWatcher<QImage> m_displayPhotoWatcher; /**< full photo read in background for the photo panel */
 
     // workers
     QThread m_displayPhotoWorkerThread;
     QThread m_pdfGeneratorWorkerThread;
+    QThread m_pageThumbnailsWorkerThread;
+    QThread m_workSaverWorkerThread;
+    QThread m_directoryScannerWorkerThread;
 };
 }
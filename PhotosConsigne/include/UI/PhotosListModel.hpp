@@ -0,0 +1,120 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file PhotosListModel.hpp
+ * \brief defines PhotosListModel
+ * \date 19/10/2026
+ */
+
+// local
+#include "Photo.hpp"
+
+// Qt
+#include <QAbstractListModel>
+#include <QThreadPool>
+#include <QPixmap>
+#include <QHash>
+#include <QSet>
+
+namespace pc{
+
+/**
+ * @brief Model of the loaded photos list, the view only asks the data of the visible rows and the icons are computed in background for them.
+ */
+class PhotosListModel : public QAbstractListModel{
+
+    Q_OBJECT
+
+public :
+
+    PhotosListModel(QObject *parent = nullptr);
+
+    ~PhotosListModel();
+
+    /**
+     * @brief Update the rows from the loaded photos, only the inserted/removed/modified rows are signaled to the view
+     * @param [in] photos
+     * @param [in] individualSets individual settings state of the set of each photo
+     */
+    void update(SPhotos photos, const QVector<bool> &individualSets);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    static constexpr int iconSize = 32;
+
+signals:
+
+    void icon_computed_signal(quint64 photoUid, int row, qint64 thumbnailKey, QImage icon);
+
+private slots:
+
+    /**
+     * @brief Store the icon computed for the photo of the row, dropped if the row was moved or removed meanwhile
+     */
+    void set_icon(quint64 photoUid, int row, qint64 thumbnailKey, QImage icon);
+
+private :
+
+    void request_icon(const SPhoto &photo, int row) const;
+
+    /**
+     * @brief State of the photo displayed by a row, the text and the color are built from it only for the visible rows
+     */
+    struct Row{
+
+        SPhoto photo = nullptr;
+        int pageId          = -1;
+        bool isADuplicate   = false;
+        bool isOnDocument   = false;
+        bool isRemoved      = false;
+        bool individualSet  = false;
+
+        bool operator==(const Row &other) const noexcept{
+            return photo == other.photo && pageId == other.pageId && isADuplicate == other.isADuplicate &&
+                   isOnDocument == other.isOnDocument && isRemoved == other.isRemoved && individualSet == other.individualSet;
+        }
+    };
+
+    struct Icon{
+        qint64 thumbnailKey = 0; /**< cache key of the photo thumbnail the icon was computed from */
+        QPixmap pixmap;
+    };
+
+    QVector<Row> m_rows;
+
+    QPixmap m_placeholderIcon;
+    QPixmap m_whiteSpaceIcon;
+    mutable QHash<quint64, Icon> m_icons;       /**< by photo uid, a reloaded photo keeps its icon until the new one is computed */
+    mutable QSet<quint64> m_iconsRequested;
+    mutable QThreadPool m_iconsPool;
+};
+}
@@ -36,14 +36,19 @@
 // local
 #include "Utility.hpp"
 #include "DocumentElements.hpp"
+#include "PhotosListModel.hpp"
 // # widgets
 #include "PreviewW.hpp"
 #include "RightSettingsW.hpp"
+#include "DiagnosticsW.hpp"
 // # generated ui
 #include "ui_PhotosConsigneMainW.h"
 #include "ui_Support.h"
 #include "ui_Help.h"
 
+// Qt
+#include <QCache>
+
 
 namespace Ui {
     class PhotosConsigneMainUI;
@@ -73,10 +78,12 @@ public :
 
     std::unique_ptr<QWidget> supportW   = nullptr;  /**< support window */
     std::unique_ptr<QWidget> helpW      = nullptr;  /**< help window */
+    std::unique_ptr<DiagnosticsW> diagnosticsW = nullptr; /**< diagnostics window */
 
     RightSettingsW settingsW;           /**< right settings widgets */
     PhotoW   photoW;                    /**< photo widget */
     PreviewW previewW;                  /**< preview widget */
+    PhotosListModel photosListModel;    /**< model of the photos list view */
 
     Ui::PhotosConsigneMainUI mainUI;    /**< ui of the main window */
 
@@ -85,7 +92,7 @@ public slots:
     void ask_for_update(bool displayZones);
 
 
-    void write_to_xml(QXmlStreamWriter &xml) const;
+    void write_to_xml(QXmlStreamWriter &xml, bool onlyOverrides = false) const;
     void load_from_xml(QXmlStreamReader &xml, bool firstPart);
 
     void display_donate_window();
@@ -103,6 +110,13 @@ public slots:
     void update_photos_list(const GlobalSettings &settings);
     void update_pages_list(const PCPages &pcPages);
 
+    /**
+     * @brief Set the cached thumbnails on the pages list items and return the pages whose thumbnail must be rendered, nearest from the current page first
+     */
+    void update_pages_thumbnails(const PCPages &pcPages, int currentPageId, QVector<int> &pagesToRender, QVector<uint> &pagesToRenderHash);
+
+    void set_page_thumbnail(uint pageHash, QImage thumbnail);
+
     void display_current_individual_set_ui(const GlobalSettings &settings);
     void display_current_individual_page_ui(const GlobalSettings &settings);
 
@@ -115,9 +129,15 @@ private:
 
     QMainWindow *m_parent = nullptr;
 
+    // pages thumbnails
+    QVector<uint> m_pagesHash;                  /**< content hash of each page of the list */
+    QCache<uint, QPixmap> m_pagesThumbnails;    /**< rendered thumbnails by page content hash */
+    QPixmap m_pagePlaceholder;
+
 signals:
 
     void settings_updated_signal();
+    void diagnostics_window_asked_signal();
     void resource_added_signal(QUrl url, QImage image);
 
     void set_progress_bar_state_signal(int state);
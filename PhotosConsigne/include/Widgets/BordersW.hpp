@@ -99,6 +99,23 @@ struct BordersW : public SettingsW {
         ui.tbColorBorder->actions()[0]->setIcon(QIcon(pix));
     }
 
+    static void read_settings_from_xml(QXmlStreamReader &xml, BordersSettings &borders){
+
+        borders.display = xml.attributes().value("enable").toInt()==1;
+        borders.width   = Utility::borders_line_width_from_index(xml.attributes().value("width").toInt());
+        Utility::borders_line_style_from_index(xml.attributes().value("style").toInt(), borders.pen);
+        borders.pen.setJoinStyle(Utility::borders_join_style_from_index(xml.attributes().value("join").toInt()));
+
+        borders.left    = xml.attributes().value("left").toInt()==1;
+        borders.top     = xml.attributes().value("top").toInt()==1;
+        borders.right   = xml.attributes().value("right").toInt()==1;
+        borders.bottom  = xml.attributes().value("bottom").toInt()==1;
+        borders.between = xml.attributes().value("between").toInt()==1;
+
+        QStringList col = xml.attributes().value("color").toString().split(" ");
+        borders.pen.setColor(QColor(col[0].toInt(),col[1].toInt(),col[2].toInt(),col[3].toInt()));
+    }
+
      void update_settings(Settings &settings) const{
 
         BordersSettings &borders = dynamic_cast<BordersSettings&>(settings);
@@ -0,0 +1,192 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+#pragma once
+
+/**
+ * \file DiagnosticsW.hpp
+ * \brief defines DiagnosticsW
+ * \date 19/10/2026
+ */
+
+// local
+#include "Counters.hpp"
+
+// Qt
+#include <QWidget>
+#include <QFormLayout>
+#include <QLabel>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QIcon>
+
+// std
+#include <algorithm>
+
+namespace pc{
+
+/**
+ * @brief Window displaying the live diagnostics counters of the application
+ */
+class DiagnosticsW : public QWidget{
+
+    Q_OBJECT
+
+public:
+
+    DiagnosticsW(){
+
+        setWindowTitle(tr("Diagnostics"));
+        setWindowIcon(QIcon(":/images/icon"));
+        setWindowFlags(Qt::Window | Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+
+        auto layout = new QFormLayout(this);
+        add_section(layout, tr("Dernier aperçu"));
+        add_row(layout, m_laPreviewPages,   tr("Mise à jour des pages"));
+        add_row(layout, m_laPreviewLayout,  tr("Mise en page"));
+        add_row(layout, m_laPreviewDraw,    tr("Dessin"));
+        add_row(layout, m_laPreviewDisplay, tr("Affichage"));
+        add_row(layout, m_laPreviewTiles,   tr("Tuiles zoomées"));
+        add_row(layout, m_laPreviewLatency, tr("Latence totale"));
+        add_section(layout, tr("Photos"));
+        add_row(layout, m_laDecodeQueue,    tr("Miniatures en attente"));
+        add_row(layout, m_laPhotosBytes,    tr("Mémoire des miniatures"));
+        add_row(layout, m_laPrefetch,       tr("Fichiers lus en avance"));
+        add_row(layout, m_laPrefetchWait,   tr("Attente des lectures"));
+        add_row(layout, m_laPrefetchBytes,  tr("Mémoire des lectures"));
+        add_section(layout, tr("Caches"));
+        add_row(layout, m_laPagesCache,     tr("Miniatures des pages"));
+        add_row(layout, m_laIconsCache,     tr("Icônes des photos"));
+        add_row(layout, m_laResourcesCache, tr("Clés des ressources"));
+        add_row(layout, m_laBackgroundsCache, tr("Fonds des pages"));
+        add_row(layout, m_laTextsCache,     tr("Mises en page des textes"));
+        add_row(layout, m_laExportCache,    tr("Pages du PDF réutilisées"));
+        add_section(layout, tr("Ressources des textes"));
+        add_row(layout, m_laResourcesBytes, tr("Images insérées"));
+        add_section(layout, tr("Utilisation des threads"));
+        add_row(layout, m_laLoaderBusy,     tr("Chargement des photos"));
+        add_row(layout, m_laPdfBusy,        tr("Aperçu et PDF"));
+        add_row(layout, m_laThumbnailsBusy, tr("Miniatures des pages"));
+        add_row(layout, m_laSaverBusy,      tr("Sauvegarde"));
+
+        connect(&m_refreshTimer, &QTimer::timeout, this, &DiagnosticsW::refresh);
+    }
+
+public slots:
+
+    void refresh(){
+
+        m_laPreviewPages->setText(ms(Counter::PreviewPagesUs));
+        m_laPreviewLayout->setText(ms(Counter::PreviewLayoutUs));
+        m_laPreviewDraw->setText(ms(Counter::PreviewDrawUs));
+        m_laPreviewDisplay->setText(ms(Counter::PreviewDisplayUs));
+        m_laPreviewTiles->setText(ms(Counter::PreviewTilesUs));
+        m_laPreviewLatency->setText(ms(Counter::PreviewLatencyUs));
+
+        m_laDecodeQueue->setText(QString::number(Counters::get(Counter::DecodeQueue)));
+        m_laPhotosBytes->setText(bytes(Counters::get(Counter::PhotosBytes)));
+        m_laPrefetch->setText(hit_rate(Counter::PrefetchHits, Counter::PrefetchMisses));
+        m_laPrefetchWait->setText(ms(Counter::PrefetchWaitUs));
+        m_laPrefetchBytes->setText(bytes(Counters::get(Counter::PrefetchBytes)));
+
+        m_laPagesCache->setText(hit_rate(Counter::PageThumbnailsHits, Counter::PageThumbnailsMisses));
+        m_laIconsCache->setText(hit_rate(Counter::PhotoIconsHits, Counter::PhotoIconsMisses));
+        m_laResourcesCache->setText(hit_rate(Counter::ResourceKeysHits, Counter::ResourceKeysMisses));
+        m_laBackgroundsCache->setText(hit_rate(Counter::BackgroundLayersHits, Counter::BackgroundLayersMisses));
+        m_laTextsCache->setText(hit_rate(Counter::TextLayoutsHits, Counter::TextLayoutsMisses));
+        m_laExportCache->setText(hit_rate(Counter::ExportedPagesHits, Counter::ExportedPagesMisses));
+
+        m_laResourcesBytes->setText(bytes(Counters::get(Counter::PdfResourcesBytes)));
+
+        // busy time since the previous refresh
+        qint64 elapsedUs = m_elapsed.isValid() ? m_elapsed.nsecsElapsed()/1000 : 0;
+        m_elapsed.start();
+        m_laLoaderBusy->setText(utilisation(Counter::PhotoLoaderBusyUs, 0, elapsedUs));
+        m_laPdfBusy->setText(utilisation(Counter::PdfGeneratorBusyUs, 1, elapsedUs));
+        m_laThumbnailsBusy->setText(utilisation(Counter::PageThumbnailsBusyUs, 2, elapsedUs));
+        m_laSaverBusy->setText(utilisation(Counter::WorkSaverBusyUs, 3, elapsedUs));
+    }
+
+protected:
+
+    void showEvent(QShowEvent *event) override{
+        QWidget::showEvent(event);
+        m_elapsed.invalidate();
+        refresh();
+        m_refreshTimer.start(500);
+    }
+
+    void hideEvent(QHideEvent *event) override{
+        QWidget::hideEvent(event);
+        m_refreshTimer.stop();
+    }
+
+private:
+
+    void add_section(QFormLayout *layout, const QString &title){
+        auto label = new QLabel(title, this);
+        label->setStyleSheet("color : rgb(0,106,255); font-weight: bold;");
+        layout->addRow(label);
+    }
+
+    void add_row(QFormLayout *layout, QLabel *&value, const QString &name){
+        value = new QLabel("-", this);
+        layout->addRow(name, value);
+    }
+
+    static QString ms(Counter counter){
+        return QString::number(Counters::get(counter)/1000., 'f', 1) + " ms";
+    }
+
+    static QString bytes(qint64 size){
+        return QString::number(size/(1024.*1024.), 'f', 1) + " Mo";
+    }
+
+    static QString hit_rate(Counter hits, Counter misses){
+        qint64 nbHits = Counters::get(hits), total = nbHits + Counters::get(misses);
+        return total > 0 ? QString::number(100.*nbHits/total, 'f', 0) + " % (" + QString::number(total) + ")" : QString("-");
+    }
+
+    QString utilisation(Counter busy, int id, qint64 elapsedUs){
+        qint64 busyUs = Counters::get(busy);
+        qint64 delta  = busyUs - m_previousBusy[id];
+        m_previousBusy[id] = busyUs;
+        return elapsedUs > 0 ? QString::number(std::min(100., 100.*delta/elapsedUs), 'f', 0) + " %" : QString("-");
+    }
+
+    QTimer m_refreshTimer;
+    QElapsedTimer m_elapsed;
+    qint64 m_previousBusy[4] = {0,0,0,0};
+
+    QLabel *m_laPreviewPages = nullptr, *m_laPreviewLayout = nullptr, *m_laPreviewDraw = nullptr, *m_laPreviewDisplay = nullptr, *m_laPreviewTiles = nullptr, *m_laPreviewLatency = nullptr;
+    QLabel *m_laDecodeQueue = nullptr, *m_laPhotosBytes = nullptr, *m_laPrefetch = nullptr, *m_laPrefetchWait = nullptr, *m_laPrefetchBytes = nullptr;
+    QLabel *m_laPagesCache = nullptr, *m_laIconsCache = nullptr, *m_laResourcesCache = nullptr, *m_laBackgroundsCache = nullptr, *m_laTextsCache = nullptr, *m_laExportCache = nullptr;
+    QLabel *m_laResourcesBytes = nullptr;
+    QLabel *m_laLoaderBusy = nullptr, *m_laPdfBusy = nullptr, *m_laThumbnailsBusy = nullptr, *m_laSaverBusy = nullptr;
+};
+}
@@ -57,6 +57,9 @@ class PageSetsW : public SettingsW{
 public :
     PageSetsW();
 
+    /**
+     * @brief Create the predefined positions buttons, the positions library is loaded only once for all the pages widgets
+     */
     void read_pos_files();
 
     static void init_ui(PageSetsW &p1, const PageSetsW &p2);
@@ -88,9 +91,21 @@ public :
 
     static bool posLoaded;
     static QVector<SetsPositionSettings> predefPositions;
+    static QVector<QIcon> predefIcons;
+
+    static constexpr quint32 posIndexVersion = 2;
 
 private :
 
+    static bool read_pos_file(const QString &path, SetsPositionSettings &pos);
+
+    /**
+     * @brief Load the .pos files of data/positions, from the cached index if the application and the positions directories did not change since it was written
+     */
+    static void load_predef_positions();
+
+    static QIcon predef_position_icon(const SetsPositionSettings &pos);
+
     QVector<QPushButton*> predefButtons;
 
     QString dsbStyle =
@@ -35,6 +35,8 @@
 // Qt
 #include <QReadWriteLock>
 #include <QThread>
+#include <QCache>
+#include <QSet>
 
 // std
 #include <memory>
@@ -80,14 +82,35 @@ public :
 
 public slots:
 
+    /**
+     * @brief Set the laid out page of the preview image, the zoomed tiles of the previous page are discarded
+     */
     void set_page(SPCPage previewPage);
 
     void set_current_pc(int idPc);
 
+    /**
+     * @brief Set the largest size in pixels the page can be zoomed to
+     */
+    void set_max_page_size(QSize maxPageSize);
+
+    /**
+     * @brief Store a rendered tile of the zoomed page, tiles of another page or zoom are ignored
+     */
+    void set_tile(SPCPage previewPage, QSize pageSize, QRect tile, QImage image);
+
 protected:
 
     virtual void mousePressEvent(QMouseEvent * ev ) override;
 
+    void mouseMoveEvent(QMouseEvent *ev) override;
+
+    void mouseReleaseEvent(QMouseEvent *ev) override;
+
+    void wheelEvent(QWheelEvent *ev) override;
+
+    void resizeEvent(QResizeEvent *ev) override;
+
     void paintEvent(QPaintEvent *event) override;
 
 signals:
@@ -102,19 +125,51 @@ signals:
 
     void current_pc_selected_signal(int totalId);
 
+    void tiles_requested_signal(SPCPage previewPage, QSize pageSize, QVector<QRect> tiles);
+
+    void larger_preview_needed_signal();
+
 private:
 
+    /**
+     * @brief Return the rectangle of the page in the widget at the current zoom
+     */
+    QRectF page_rect() const;
+
+    /**
+     * @brief Keep the page covering the widget when it is larger
+     */
+    void clamp_zoom_center();
+
+    static QString tile_key(const QSize &pageSize, const QPoint &tilePos);
+
     int m_currentRectId;
     QRectF m_currentPCRect;
     QRectF m_rectRelative;
 
     QTimer m_rectTimer;
+    QTimer m_resizeTimer;
 
     SPCPage m_previewPage = nullptr;
 
+    // zoom
+    qreal m_zoom = 1.;                  /**< 1: whole page fitted in the widget */
+    QPointF m_zoomCenter{0.5,0.5};      /**< page position displayed at the widget center, relative to the page size */
+    QSize m_maxPageSize;
+    bool m_dragging = false;
+    QPoint m_dragPos;
+
+    // tiles of the zoomed page, rendered by the pdf generator worker
+    QCache<QString, QImage> m_tiles{64*1024};  /**< cost in KB */
+    QSet<QString> m_requestedTiles;             /**< tiles asked and not received yet */
+
     QThread m_workerThread;
     std::unique_ptr<PreviewWorker> m_worker = nullptr;        
 
+public :
+
+    static constexpr int tileSize = 256;
+    static constexpr qreal zoomStep = 1.25;
 };
 
 
@@ -239,11 +239,13 @@ public:
     TextEdit* textEdit() {return m_textEdit->textEdit();}
 
     void init_with_another(const RichTextEditW &richTextEdit, std::shared_ptr<QString> html = nullptr);
+    void clear_text();
 
     std::shared_ptr<QString> html() const noexcept{return m_html;}
 
     void write_to_xml(QXmlStreamWriter &xml) const;
     void load_from_xml(QXmlStreamReader &xml);
+    static std::shared_ptr<QString> read_html_from_xml(QXmlStreamReader &xml);
 
     QTransform t = QTransform(1,0,0,0,1,0,0,0,1);
 
@@ -104,6 +104,26 @@ struct SetStyleW : public SettingsW{
         ImagePositionW::init_ui(s1.imagePositionW, s2.imagePositionW);
     }
 
+    static void read_settings_from_xml(QXmlStreamReader &xml, StyleSettings &style){
+
+        style.ratioTextPhoto            = xml.attributes().value("ratioPC").toDouble();
+        style.textPositionFromPhotos    = static_cast<Position>(xml.attributes().value("position").toInt());
+
+        QXmlStreamReader::TokenType token = QXmlStreamReader::TokenType::StartElement;
+        while(!xml.hasError()) {
+
+            if(token == QXmlStreamReader::TokenType::EndElement && xml.name() == "SetStyle"){
+                break;
+            }else if(token == QXmlStreamReader::TokenType::StartElement){
+
+                if(xml.name() == "ImagePosition"){
+                    ImagePositionW::read_settings_from_xml(xml, style.imagePosition);
+                }
+            }
+            token = xml.readNext();
+        }
+    }
+
     void update_settings(Settings &settings) const{
 
         StyleSettings &style = dynamic_cast<StyleSettings&>(settings);
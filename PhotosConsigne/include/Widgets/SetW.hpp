@@ -39,6 +39,9 @@
 #include "BordersW.hpp"
 #include "MiscW.hpp"
 
+// Qt
+#include <QRegularExpression>
+
 // generated ui
 #include "ui_Set.h"
 
@@ -53,6 +56,18 @@ static int setUICounter = 0;
 struct SetW;
 using SSetW = std::shared_ptr<SetW>;
 
+/**
+ * @brief Individual set values kept without any widget, the individual set editor is bound to the displayed one
+ */
+struct IndividualSetData{
+
+    int id = 0;
+    bool enabled = false;
+    SSetSettings settings = nullptr;    // values used for building the pages
+    QString state;                      // serialized content of the editor (see SetW::write_state)
+};
+using SIndividualSetData = std::shared_ptr<IndividualSetData>;
+
 struct SetW : public SettingsW{
 
     Q_OBJECT
@@ -172,6 +187,116 @@ public:
     }
 
 
+    QString write_state(bool withText = true) const{
+
+        QString state;
+        QXmlStreamWriter xml(&state);
+        xml.writeStartElement("Set");
+        if(withText){
+            textW.write_to_xml(xml);
+        }
+        bordersW.write_to_xml(xml);
+        styleW.write_to_xml(xml);
+        xml.writeEndElement();
+        return state;
+    }
+
+    void load_state(const QString &state){
+
+        bool textLoaded = false;
+        QXmlStreamReader xml(state);
+        while(!xml.atEnd() && !xml.hasError()) {
+
+            if(xml.readNext() == QXmlStreamReader::TokenType::StartElement){
+
+                if(xml.name() == "RichText"){
+                    textW.load_from_xml(xml);
+                    textLoaded = true;
+                }else if(xml.name() == "SetStyle"){
+                    styleW.load_from_xml(xml);
+                }else if(xml.name() == "Borders"){
+                    bordersW.load_from_xml(xml);
+                }
+            }
+        }
+
+        if(!textLoaded){
+            textW.clear_text();
+        }
+    }
+
+    static QString state_with_ratio(const QString &state, qreal ratio){
+
+        // text content is escaped, the only "<SetStyle" of the state is the element itself
+        QString newState = state;
+        newState.replace(QRegularExpression("<SetStyle ratioPC=\"[^\"]*\""), "<SetStyle ratioPC=\"" + QString::number(ratio) + "\"");
+        return newState;
+    }
+
+    static void write_state_to_xml(const QString &state, QXmlStreamWriter &xml){
+
+        // copy the children of the state root element
+        QXmlStreamReader reader(state);
+        int depth = 0;
+        while(!reader.atEnd() && !reader.hasError()) {
+
+            reader.readNext();
+            if(reader.isStartElement() && depth++ == 0){
+                continue;
+            }
+            if(reader.isEndElement() && --depth == 0){
+                continue;
+            }
+            if(depth > 0){
+                xml.writeCurrentToken(reader);
+            }
+        }
+    }
+
+    static QString read_state_from_xml(QXmlStreamReader &xml){
+
+        // xml is on the start of a "Set" element
+        QString state;
+        QXmlStreamWriter writer(&state);
+        writer.writeCurrentToken(xml);
+        int depth = 1;
+        while(depth > 0 && !xml.atEnd() && !xml.hasError()) {
+
+            xml.readNext();
+            if(xml.isStartElement()){
+                ++depth;
+            }else if(xml.isEndElement()){
+                --depth;
+            }
+            writer.writeCurrentToken(xml);
+        }
+        return state;
+    }
+
+    static void read_settings_from_state(const QString &state, SetSettings &settings){
+
+        // same values than load_state followed by update_settings, without any widget
+        settings.text.html = nullptr;
+        QXmlStreamReader xml(state);
+        while(!xml.atEnd() && !xml.hasError()) {
+
+            if(xml.readNext() == QXmlStreamReader::TokenType::StartElement){
+
+                if(xml.name() == "RichText"){
+                    settings.text.html = RichTextEditW::read_html_from_xml(xml);
+                }else if(xml.name() == "SetStyle"){
+                    SetStyleW::read_settings_from_xml(xml, settings.style);
+                }else if(xml.name() == "Borders"){
+                    BordersW::read_settings_from_xml(xml, settings.borders);
+                }
+            }
+        }
+
+        if(settings.text.html == nullptr){ // the sets always draw a text
+            settings.text.html = std::make_shared<QString>(QTextDocument().toHtml());
+        }
+    }
+
     void update_settings(Settings &settings) const{
 
         SetSettings &set = dynamic_cast<SetSettings&>(settings);
@@ -248,6 +248,15 @@ public :
     }
 
 
+    static void read_settings_from_xml(QXmlStreamReader &xml, ImagePositionSettings &imagePos){
+
+        imagePos.adjustment = static_cast<PhotoAdjust>(xml.attributes().value("Adjust").toInt());
+        imagePos.alignment  = static_cast<PhotoPosition>(xml.attributes().value("Position").toInt());
+        imagePos.scale      = xml.attributes().value("Scale").toDouble();
+        imagePos.xPos       = 0.001 * xml.attributes().value("SliderH").toInt();
+        imagePos.yPos       = 0.001 * xml.attributes().value("SliderV").toInt();
+    }
+
     void update_settings(Settings &settings) const{
 
         ImagePositionSettings &imagePos = dynamic_cast<ImagePositionSettings&>(settings);
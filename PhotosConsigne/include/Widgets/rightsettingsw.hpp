@@ -56,15 +56,14 @@ namespace pc{
             // init ui
             ui.setupUi(this);
 
-            // header
-            ui.vlHeader->addWidget(&headerW);
-            connect(&headerW, &HeaderW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);            
-            connect(headerW.richTextW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
-
-            // footer
-            ui.vlFooter->addWidget(&footerW);
-            connect(&footerW, &FooterW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);
-            connect(footerW.richTextW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
+            // header and footer editors are created the first time their panel is displayed
+            connect(ui.tbRight, &QToolBox::currentChanged, this, [&](int index){
+                if(index == 4){
+                    header_w();
+                }else if(index == 5){
+                    footer_w();
+                }
+            });
 
             // all pages
             ui.vlAllPages->addWidget(&globalPageW);
@@ -110,30 +109,35 @@ namespace pc{
 
             // misc all sets
             connect(globalSetW.miscW.ui.pbGlobal, &QPushButton::clicked, this, [&]{
-                for(auto &&set : setsValidedW){
-                    Utility::safe_init_checkboxe_checked_state(set->ui.cbEnableIndividualConsign, false);
-                    set->ui.frameSet->setEnabled(false);
+                for(auto &&set : setsValided){
+                    set->enabled = false;
                 }
+                refresh_individual_set_ui();
                 emit settings_updated_signal(true);
             });
             connect(globalSetW.miscW.ui.pbPerPage, &QPushButton::clicked, this, [&]{
-                for(auto &&set : setsValidedW){
-                    Utility::safe_init_checkboxe_checked_state(set->ui.cbEnableIndividualConsign, true);
-                    set->ui.frameSet->setEnabled(true);
+                for(auto &&set : setsValided){
+                    set->enabled = true;
                 }
+                refresh_individual_set_ui();
                 emit settings_updated_signal(true);
             });
             connect(globalSetW.miscW.ui.pbReplaceLocalWIthGlobal, &QPushButton::clicked, this, [&]{
 
-                for(auto &&set : setsLoadedW){
-                    SetW::init_ui(*set, globalSetW, true);
+                SetSettings globalSettings;
+                globalSetW.update_settings(globalSettings);
+                SSetSettings settings = std::make_shared<const SetSettings>(globalSettings);
+                QString state = globalSetW.write_state();
+                for(auto &&set : setsLoaded){
+                    set->settings = settings;
+                    set->state    = state;
                 }
+                refresh_individual_set_ui();
 
                 emit settings_updated_signal(true);
             });
             delete globalSetW.miscW.ui.pbReplaceGlobalWithLocal;
 
-
             // all sets
             ui.vlAllSets->addWidget(&globalSetW);
             delete globalSetW.ui.frameIndividualSettings;
@@ -143,15 +147,19 @@ namespace pc{
             globalSetW.global = true;
             globalSetW.textW.init_style(RichTextType::globalConsign);
             connect(globalSetW.textW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
-            connect(&globalSetW, &SetW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);           
+            connect(&globalSetW, &SetW::settings_updated_signal, this, [&](bool displayZones){
+                m_setTemplate = nullptr;
+                emit settings_updated_signal(displayZones);
+            });
 
+            // the individual set editor is created the first time a set is displayed
             ui.tbRight->setCurrentIndex(0);
         }
 
         ~RightSettingsW(){
 
-            setsLoadedW.clear();
-            setsValidedW.clear();
+            setsLoaded.clear();
+            setsValided.clear();
             pagesW.clear();
         }
 
@@ -203,30 +211,135 @@ namespace pc{
 
         void insert_individual_set(int index){
 
-            setsLoadedW.insert(index,std::make_shared<SetW>());
-            SetW *setW = setsLoadedW[index].get();
-            delete setW->miscW.ui.pbReplaceLocalWIthGlobal;
-            delete setW->miscW.ui.line1;
-            delete setW->miscW.ui.frameApply;
+            // init new individual set with the current global set and the default individual text
+            const IndividualSetData &setTemplate = individual_set_template();
+            setsLoaded.insert(index, std::make_shared<IndividualSetData>(setTemplate));
+            setsLoaded[index]->id = setUICounter++;
+        }
 
-            ui.vlSelectedSet->addWidget(setW);
-            setW->hide();
+        void remove_individual_set(int index){
 
-            connect(setW->textW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
+            if(setsLoaded[index] == m_boundSet){
+                m_boundSet = nullptr;
+            }
+            setsLoaded.removeAt(index);
+        }
 
-            //  set style
-            connect(setW, &SetW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);
-            connect(&setW->miscW, &MiscSetW::replace_global_with_individual_signal, this, [=]{
-                SetW::init_ui(globalSetW, *setW, true);
-                emit settings_updated_signal(true);
-            });
+        HeaderW &header_w(){
+            if(m_headerW == nullptr){
+                create_header_w();
+            }
+            return *m_headerW;
+        }
 
-            // init new individual ui with global ui
-            SetW::init_ui(*setW, globalSetW, false);
+        FooterW &footer_w(){
+            if(m_footerW == nullptr){
+                create_footer_w();
+            }
+            return *m_footerW;
         }
 
-        void remove_individual_set(int index){
-            setsLoadedW.removeAt(index);
+        bool header_w_created() const noexcept{
+            return m_headerW != nullptr;
+        }
+
+        bool footer_w_created() const noexcept{
+            return m_footerW != nullptr;
+        }
+
+        void update_header_settings(HeaderSettings &header) const{
+
+            if(m_headerW != nullptr){
+                m_headerW->update_settings(header);
+            }else{
+                header.enabled   = false;
+                header.ratio     = 0.;
+                header.text.html = nullptr;
+            }
+        }
+
+        void update_footer_settings(FooterSettings &footer) const{
+
+            if(m_footerW != nullptr){
+                m_footerW->update_settings(footer);
+            }else{
+                footer.enabled   = false;
+                footer.ratio     = 0.;
+                footer.text.html = nullptr;
+            }
+        }
+
+        SetW &individual_set_w(){
+            if(m_individualSetW == nullptr){
+                create_individual_set_w();
+            }
+            return *m_individualSetW;
+        }
+
+        bool individual_set_w_created() const noexcept{
+            return m_individualSetW != nullptr;
+        }
+
+        /**
+         * @brief Add a resource loaded from a work to the lazy editors, kept for the editors not created yet
+         */
+        void add_lazy_editors_resource(const QUrl &url, const QImage &image){
+            m_resources.push_back({url, image});
+            if(m_headerW != nullptr){
+                m_headerW->richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
+            }
+            if(m_footerW != nullptr){
+                m_footerW->richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
+            }
+            if(m_individualSetW != nullptr){
+                m_individualSetW->textW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
+            }
+        }
+
+        void bind_individual_set(SIndividualSetData set){
+
+            if(set == m_boundSet){
+                return;
+            }
+
+            m_boundSet = nullptr; // no update of the data while loading the editor
+            SetW &setW = individual_set_w();
+            setW.textW.init_with_another(globalSetW.textW);
+            setW.load_state(set->state);
+            Utility::safe_init_checkboxe_checked_state(setW.ui.cbEnableIndividualConsign, set->enabled);
+            setW.ui.frameSet->setEnabled(set->enabled);
+            setW.id = set->id;
+            m_boundSet = set;
+        }
+
+        void refresh_individual_set_ui(){
+
+            if(m_boundSet != nullptr){
+                SIndividualSetData set = m_boundSet;
+                m_boundSet = nullptr;
+                bind_individual_set(set);
+            }
+        }
+
+        void set_all_sets_ratio(qreal ratio){
+
+            Utility::safe_init_double_spinbox_value(globalSetW.styleW.ui.dsbRatioPC, ratio);
+            Utility::safe_init_slider_value(globalSetW.styleW.ui.hsRatioPC, static_cast<int>(ratio*10000));
+            m_setTemplate = nullptr;
+
+            // sets sharing the same settings keep sharing them
+            QHash<const SetSettings*, SSetSettings> newSettings;
+            for(auto &&set : setsLoaded){
+
+                if(!newSettings.contains(set->settings.get())){
+                    SetSettings settings = *set->settings;
+                    settings.style.ratioTextPhoto = ratio;
+                    newSettings[set->settings.get()] = std::make_shared<const SetSettings>(settings);
+                }
+                set->settings = newSettings[set->settings.get()];
+                set->state    = SetW::state_with_ratio(set->state, ratio);
+            }
+            refresh_individual_set_ui();
         }
 
         void reset_individual_sets(int nbPhotos){
@@ -235,7 +348,11 @@ namespace pc{
             qreal offset        = 250. / nbPhotos;
 
             // clean
-            setsLoadedW.clear();
+            m_boundSet = nullptr;
+            if(m_individualSetW != nullptr){
+                m_individualSetW->hide();
+            }
+            setsLoaded.clear();
 
             // insert new consigns
             for(int ii = 0; ii < nbPhotos; ++ii){
@@ -263,17 +380,34 @@ namespace pc{
         }
 
         void display_header_panel(){
+            header_w();
             Utility::safe_init_tool_box_index(ui.tbRight, 4);
         }
 
         void display_footer_panel(){
+            footer_w();
             Utility::safe_init_tool_box_index(ui.tbRight, 5);
         }
 
-        void write_to_xml(QXmlStreamWriter &xml) const{
+        void write_to_xml(QXmlStreamWriter &xml, bool onlyOverrides = false) const{
 
-            headerW.write_to_xml(xml);
-            footerW.write_to_xml(xml);
+            // an editor not created yet has its default values, which are a disabled section
+            if(m_headerW != nullptr){
+                m_headerW->write_to_xml(xml);
+            }else{
+                xml.writeStartElement("Header");
+                xml.writeAttribute("enabled", "0");
+                xml.writeAttribute("default", "1");
+                xml.writeEndElement();
+            }
+            if(m_footerW != nullptr){
+                m_footerW->write_to_xml(xml);
+            }else{
+                xml.writeStartElement("Footer");
+                xml.writeAttribute("enabled", "0");
+                xml.writeAttribute("default", "1");
+                xml.writeEndElement();
+            }
 
             xml.writeStartElement("Global");
             globalPageW.write_to_xml(xml);
@@ -282,12 +416,27 @@ namespace pc{
 
             xml.writeStartElement("Individual");
             xml.writeAttribute("nb_pages", QString::number(pagesW.size()));
-            xml.writeAttribute("nb_sets", QString::number(pagesW.size()));
+            xml.writeAttribute("nb_sets", QString::number(setsLoaded.size()));
+            // with onlyOverrides, the sets still equal to the global one are not written
+            xml.writeAttribute("overrides", QString::number(onlyOverrides));
             for(const auto &pageW : pagesW){
                 pageW->write_to_xml(xml);
             }
-            for(const auto &set : setsLoadedW){
-                set->write_to_xml(xml);
+            const IndividualSetData &setTemplate = individual_set_template();
+            for(int ii = 0; ii < setsLoaded.size(); ++ii){
+
+                const auto &set = setsLoaded[ii];
+                if(onlyOverrides && !set->enabled && set->state == setTemplate.state){
+                    continue;
+                }
+
+                xml.writeStartElement("Set");
+                xml.writeAttribute("index", QString::number(ii));
+                xml.writeAttribute("id", QString::number(set->id));
+                xml.writeAttribute("global", "0");
+                xml.writeAttribute("enabled", QString::number(set->enabled));
+                SetW::write_state_to_xml(set->state, xml);
+                xml.writeEndElement();
             }
 
             xml.writeEndElement();
@@ -296,11 +445,15 @@ namespace pc{
 
         void load_from_xml(QXmlStreamReader &xml){
 
+            m_boundSet = nullptr;
+
             QXmlStreamReader::TokenType token = QXmlStreamReader::TokenType::StartElement;
             bool global = false;
             bool individual = false;
+            bool overrides  = false;
             int currentPageId = 0;
             int currentSetId  = 0;
+            QVector<bool> setsRead(setsLoaded.size(), false);
             while(!xml.hasError()) {
 
                 if(token == QXmlStreamReader::TokenType::EndElement && xml.name() == "Document"){                    
@@ -308,16 +461,23 @@ namespace pc{
 
                 }else if(token == QXmlStreamReader::TokenType::StartElement){
 
+                    // a default section is only loaded into an editor already created
+                    const bool defaultSection = xml.attributes().value("default").toInt() == 1;
                     if(xml.name() == "Header"){
-                        headerW.load_from_xml(xml);
+                        if(!defaultSection || m_headerW != nullptr){
+                            header_w().load_from_xml(xml);
+                        }
                     }else if(xml.name() == "Footer"){
-                        footerW.load_from_xml(xml);
+                        if(!defaultSection || m_footerW != nullptr){
+                            footer_w().load_from_xml(xml);
+                        }
                     }else if(xml.name() == "Global"){
                         global = true;
                     }
                     else if(xml.name() == "Individual"){
                         individual = true;
                         global = false;
+                        overrides = xml.attributes().value("overrides").toInt() == 1;
                     }
                     else if(xml.name() == "Page"){
                         if(global){
@@ -330,14 +490,33 @@ namespace pc{
                     }else if(xml.name() == "Set"){
                         if(global){
                             globalSetW.load_from_xml(xml);
+                            m_setTemplate = nullptr;
                         }else if(individual){
-                            setsLoadedW[currentSetId++]->load_from_xml(xml);
+                            if(xml.attributes().hasAttribute("index")){
+                                currentSetId = xml.attributes().value("index").toInt();
+                            }
+                            if(currentSetId >= 0 && currentSetId < setsLoaded.size()){
+                                setsRead[currentSetId] = true;
+                                load_individual_set_from_xml(*setsLoaded[currentSetId++], xml);
+                            }
                         }
                     }
                 }
 
                 token = xml.readNext();
             }
+
+            // sets not written are equal to the loaded global one
+            if(overrides){
+                const IndividualSetData &setTemplate = individual_set_template();
+                for(int ii = 0; ii < setsLoaded.size(); ++ii){
+                    if(!setsRead[ii]){
+                        setsLoaded[ii]->enabled  = false;
+                        setsLoaded[ii]->settings = setTemplate.settings;
+                        setsLoaded[ii]->state    = setTemplate.state;
+                    }
+                }
+            }
         }
 
 
@@ -345,14 +524,108 @@ namespace pc{
         Ui::RightSettingsUI ui;
 
         // widgets
-        HeaderW         headerW;
-        FooterW         footerW;
-
         SetW            globalSetW;
         PageW           globalPageW;
 
+
         QList<SPageW>   pagesW;
-        QList<SSetW>    setsLoadedW;
-        QList<SSetW>    setsValidedW;
+
+        // data
+        QList<SIndividualSetData> setsLoaded;
+        QList<SIndividualSetData> setsValided;
+
+    private:
+
+        void create_header_w(){
+
+            m_headerW = std::make_unique<HeaderW>();
+            ui.vlHeader->addWidget(m_headerW.get());
+            connect(m_headerW.get(), &HeaderW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);
+            connect(m_headerW->richTextW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
+
+            for(const auto &resource : m_resources){
+                m_headerW->richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, resource.first, resource.second);
+            }
+        }
+
+        void create_footer_w(){
+
+            m_footerW = std::make_unique<FooterW>();
+            ui.vlFooter->addWidget(m_footerW.get());
+            connect(m_footerW.get(), &FooterW::settings_updated_signal, this, &RightSettingsW::settings_updated_signal);
+            connect(m_footerW->richTextW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
+
+            for(const auto &resource : m_resources){
+                m_footerW->richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, resource.first, resource.second);
+            }
+        }
+
+        void create_individual_set_w(){
+
+            m_individualSetW = std::make_unique<SetW>();
+            delete m_individualSetW->miscW.ui.pbReplaceLocalWIthGlobal;
+            delete m_individualSetW->miscW.ui.line1;
+            delete m_individualSetW->miscW.ui.frameApply;
+            ui.vlSelectedSet->addWidget(m_individualSetW.get());
+            m_individualSetW->hide();
+    
+            connect(m_individualSetW->textW.textEdit(), &TextEdit::resource_added_signal, this, &RightSettingsW::resource_added_signal);
+            connect(m_individualSetW.get(), &SetW::settings_updated_signal, this, [&](bool displayZones){
+    
+                if(m_boundSet != nullptr){
+                    SetSettings settings;
+                    m_individualSetW->update_settings(settings);
+                    m_boundSet->enabled  = m_individualSetW->ui.cbEnableIndividualConsign->isChecked();
+                    m_boundSet->settings = share_settings(m_boundSet->settings, settings);
+                    m_boundSet->state    = m_individualSetW->write_state();
+                }
+                emit settings_updated_signal(displayZones);
+            });
+            connect(&m_individualSetW->miscW, &MiscSetW::replace_global_with_individual_signal, this, [&]{
+                SetW::init_ui(globalSetW, *m_individualSetW, true);
+                m_setTemplate = nullptr;
+                emit settings_updated_signal(true);
+            });
+
+            for(const auto &resource : m_resources){
+                m_individualSetW->textW.textEdit()->document()->addResource(QTextDocument::ImageResource, resource.first, resource.second);
+            }
+        }
+
+        const IndividualSetData &individual_set_template() const{
+
+            if(m_setTemplate == nullptr){
+
+                // a new editor has the default individual text, its other values are taken from the global set
+                SetW templateW;
+                SetW::init_ui(templateW, globalSetW, false);
+
+                SetSettings settings;
+                templateW.update_settings(settings);
+
+                m_setTemplate = std::make_shared<IndividualSetData>();
+                m_setTemplate->settings = std::make_shared<const SetSettings>(settings);
+                m_setTemplate->state    = templateW.write_state();
+            }
+            return *m_setTemplate;
+        }
+
+        void load_individual_set_from_xml(IndividualSetData &set, QXmlStreamReader &xml){
+
+            // the values are parsed from the state, the editor will be loaded only for the displayed set
+            set.enabled = xml.attributes().value("enabled").toInt() == 1;
+            set.state   = SetW::read_state_from_xml(xml);
+
+            SetSettings settings;
+            SetW::read_settings_from_state(set.state, settings);
+            set.settings = share_settings(set.settings, settings);
+        }
+
+        std::unique_ptr<HeaderW> m_headerW = nullptr;
+        std::unique_ptr<FooterW> m_footerW = nullptr;
+        std::unique_ptr<SetW> m_individualSetW = nullptr;
+        QVector<QPair<QUrl, QImage>> m_resources; /**< resources loaded from works */
+        SIndividualSetData m_boundSet    = nullptr;
+        mutable SIndividualSetData m_setTemplate = nullptr; /**< built from the global set when needed */
     };
 }
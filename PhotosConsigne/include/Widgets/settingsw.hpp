@@ -56,6 +56,9 @@ struct Utility{
     static qreal borders_line_width_from_comboBox(QComboBox *cb);
     static Qt::PenJoinStyle borders_join_style_from_comboBox(QComboBox *cb);
     static void borders_line_style_from_comboBox(QComboBox *cb, QPen &pen);
+    static qreal borders_line_width_from_index(int index);
+    static Qt::PenJoinStyle borders_join_style_from_index(int index);
+    static void borders_line_style_from_index(int index, QPen &pen);
     static Qt::BrushStyle pattern_style_comboBox(QComboBox *cb);
     static void associate_double_spinbox_with_slider(QDoubleSpinBox *sb, QSlider *slider);
     static void associate_double_spinbox_with_slider(QDoubleSpinBox *sb1, QSlider *slider1, QDoubleSpinBox *sb2, QSlider *slider2);
@@ -0,0 +1,146 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+#pragma once
+
+/**
+ * \file DirectoryScannerWorker.hpp
+ * \brief defines DirectoryScannerWorker
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QDateTime>
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+// std
+#include <atomic>
+
+namespace pc {
+
+/**
+ * @brief Enumerate the photos of a directory tree in background, the paths are sent by batches as soon as they are found,
+ * a watched directory sends its new and modified photos once they are completely written
+ */
+class DirectoryScannerWorker : public QObject{
+
+    Q_OBJECT
+
+public :
+
+    DirectoryScannerWorker();
+
+    /**
+     * @brief Stop the current scan, can be called from any thread
+     */
+    void cancel();
+
+    /**
+     * @brief Return the lower case suffixes of the photos formats readable with QImageReader
+     */
+    static QSet<QString> supported_suffixes();
+
+public slots :
+
+    /**
+     * @brief Send the photos of the directory sorted by name, then the ones of its sub-directories if recursive
+     */
+    void scan_directory(QString directory, bool recursive);
+
+    /**
+     * @brief Watch the directory (hot folder), the photos not already sent by a scan are sent at once, then the new ones as they arrive
+     */
+    void watch_directory(QString directory, bool recursive);
+
+    void stop_watching();
+
+private slots :
+
+    /**
+     * @brief Compare the whole watched tree with the files already sent, a file is sent when its size and date are stable between two checks
+     */
+    void check_watched_directory();
+
+    /**
+     * @brief Same as check_watched_directory for the notified directories and the ones with files not stable yet only
+     */
+    void check_changed_directories();
+
+signals :
+
+    void photos_found_signal(QStringList photosPath);
+
+    void photos_modified_signal(QStringList photosPath);
+
+    void end_scanning_signal(int nbPhotosFound, bool canceled);
+
+private :
+
+    struct FileState{
+        qint64 size;
+        QDateTime lastModified;
+        bool operator==(const FileState &other) const{
+            return size == other.size && lastModified == other.lastModified;
+        }
+    };
+
+    /**
+     * @brief Return the supported photos of the directory sorted by name
+     */
+    QStringList photos_of(const QDir &dir) const;
+
+    static QStringList sub_directories_of(const QDir &dir);
+
+    /**
+     * @brief Check the files of the directories, the sub-directories are all checked if recursive, otherwise only the new ones
+     */
+    void check_directories(QStringList directories, bool recursive);
+
+    static FileState state_of(const QString &path);
+
+    QSet<QString> m_supportedSuffixes; /**< lower case suffixes of the formats readable with QImageReader */
+    std::atomic<bool> m_cancel{false};
+
+    // watch
+    QString m_watchedDirectory;
+    bool m_watchRecursive = false;
+    QFileSystemWatcher *m_watcher = nullptr;  /**< children of the worker to be moved with it in its thread */
+    QTimer *m_checkTimer  = nullptr;          /**< check soon after a notification or for the files not stable yet */
+    QTimer *m_rescanTimer = nullptr;          /**< periodic check, notifications are missing for network shares and files modified in place */
+    QSet<QString> m_watchedDirectories;       /**< absolute paths given to the watcher */
+    QSet<QString> m_changedDirectories;       /**< notified since the last check */
+    QHash<QString, FileState> m_sentFiles;    /**< files already sent, by scans or by the watch, removed when deleted */
+    QHash<QString, FileState> m_pendingFiles; /**< new or modified files waiting for a stable state */
+};
+}
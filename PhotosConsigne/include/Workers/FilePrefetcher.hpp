@@ -0,0 +1,97 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+#pragma once
+
+/**
+ * \file FilePrefetcher.hpp
+ * \brief defines FilePrefetcher
+ * \date 19/10/2026
+ */
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace pc {
+
+/**
+ * @brief I/O stage reading the upcoming files in memory ahead of the decoders, with a limit of bytes held
+ */
+class FilePrefetcher{
+
+public:
+
+    FilePrefetcher(qint64 maxBytes = 64*1024*1024, int nbReaders = 2);
+
+    ~FilePrefetcher();
+
+    /**
+     * @brief Define the upcoming files in decoding order, the buffers of the files not given anymore are released
+     */
+    void prefetch(const QStringList &paths);
+
+    /**
+     * @brief Return the content of the file, wait for it if being read, read it directly if not prefetched
+     */
+    QByteArray take(const QString &path);
+
+    void clear();
+
+    /**
+     * @brief Read a whole file with large sequential reads
+     */
+    static QByteArray read_file(const QString &path);
+
+    /**
+     * @brief Drop the file from the system page cache (Linux only), for cold cache measurements
+     */
+    static bool evict_from_cache(const QString &path);
+
+private:
+
+    void schedule_reads();
+
+    QMutex m_locker;
+    QWaitCondition m_readDone;
+    QThreadPool m_readers;
+
+    QStringList m_pending;              /**< upcoming files not read yet */
+    QSet<QString> m_reading;
+    QHash<QString, QByteArray> m_ready;
+
+    qint64 m_bytesHeld = 0;
+    const qint64 m_maxBytes;
+    const int m_nbReaders;
+};
+}
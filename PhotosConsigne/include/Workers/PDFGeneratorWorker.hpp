@@ -37,38 +37,117 @@
 // local
 #include "Utility.hpp"
 #include "DocumentElements.hpp"
+#include "Counters.hpp"
 
 // std
 #include <atomic>
 
 // Qt
 #include <QPrinter>
+#include <QPdfWriter>
 #include <QUrl>
 #include <QTextDocument>
+#include <QPicture>
+#include <QCache>
+#include <QTemporaryDir>
 
 namespace pc{
 
+/**
+ * @brief Composed backgrounds of a page (page, header and footer), cached by settings and target size
+ */
+struct BackgroundLayer{
+
+    BackGroundSettings page;
+    BackGroundSettings header;
+    BackGroundSettings footer;
+    bool headerEnabled = false;
+    bool footerEnabled = false;
+
+    QRectF pageRect;
+    QRectF headerRect;
+    QRectF footerRect;
+    qint64 photosKey[3] = {0,0,0};  /**< thumbnails may be decoded after the settings creation */
+    int photosRotation[3] = {0,0,0};
+
+    bool preview = false;
+    qreal factorUpscale = 1.;
+
+    QImage image;       /**< raster targets */
+    QPicture picture;   /**< pdf target, the replayed photos are the same images and are written once in the file */
+
+    bool same_key(const BackgroundLayer &other) const noexcept{
+        return preview == other.preview && factorUpscale == other.factorUpscale &&
+               pageRect == other.pageRect && headerRect == other.headerRect && footerRect == other.footerRect &&
+               headerEnabled == other.headerEnabled && footerEnabled == other.footerEnabled &&
+               std::equal(photosKey, photosKey + 3, other.photosKey) && std::equal(photosRotation, photosRotation + 3, other.photosRotation) &&
+               page == other.page && header == other.header && footer == other.footer;
+    }
+};
+
+/**
+ * @brief Page of the last export rendered alone in a PDF file, spliced in the next exports while its hash is unchanged
+ */
+struct ExportedPage{
+    SCPCPage page = nullptr;    /**< kept alive so its address and the addresses of its settings are not reused */
+    QByteArray hash;
+    QString file;
+};
+
 class PDFGeneratorWorker : public QObject {
 
     Q_OBJECT
 
 public :
 
-    PDFGeneratorWorker(){}
+    /**
+     * @param [in] busyCounter diagnostics counter receiving the time spent working
+     */
+    PDFGeneratorWorker(Counter busyCounter = Counter::PdfGeneratorBusyUs) : m_busyCounter(busyCounter){}
+
+    /**
+     * @brief Draw a page of the document
+     * @param [in] pcPages document snapshot the page comes from
+     * @param [in] pcPage page with its sizes computed (see PCPage::layout)
+     */
+    void draw_page(QPainter &painter, const PCPages &pcPages, SPCPage pcPage, const int idPageToDraw, const qreal factorUpscale, const bool preview, const bool drawZones);
 
-    void draw_page(QPainter &painter, PCPages &pcPages, const int idPageToDraw, const qreal factorUpscale, const bool preview, const bool drawZones);
+    /**
+     * @brief Draw a rich text, the layout is computed at the reference scale and shared between the preview and the export resolutions
+     * @param [in] infos informations replacing the text tags, factorUpscale is the painter scale
+     */
+    void draw_html(QPainter &painter, const QString &html, ExtraPCInfo infos, QRectF upperRect, QRectF docRect);
 
-    void draw_html(QPainter &painter, QString html, QRectF upperRect, QRectF docRect);
+    /**
+     * @brief Draw a rich text already formatted at the reference scale (see Drawing::format_html_for_generation)
+     */
+    void draw_formatted_html(QPainter &painter, const QString &html, qreal factor, QRectF upperRect, QRectF docRect);
 
 
 public slots :
 
     void kill();
 
-    void generate_preview(PCPages pcPages, int pageIdToDraw, bool drawZones);
+    /**
+     * @brief Render the page fitted in the target size (device pixels of the preview widget), with at most maxPreviewDPI
+     */
+    void generate_preview(PCPages pcPages, int pageIdToDraw, bool drawZones, QSize targetSize);
+
+    /**
+     * @brief Render tiles of the last previewed page laid out at a larger size, a new call replaces the tiles not rendered yet
+     * @param [in] previewPage page of the preview the tiles are asked for, outdated requests are dropped
+     * @param [in] pageSize size of the whole zoomed page in pixels
+     * @param [in] tiles rectangles of the zoomed page to render
+     */
+    void generate_preview_tiles(SPCPage previewPage, QSize pageSize, QVector<QRect> tiles);
 
     void generate_PDF(PCPages pcPages);
 
+    /**
+     * @brief Render small thumbnails of the given pages one by one, a new call replaces the pages not rendered yet
+     */
+    void generate_pages_thumbnails(PCPages pcPages, QVector<int> pagesId, QVector<uint> pagesHash);
+
     void init_document();
 
     void add_resource(QUrl url, QImage image);
@@ -81,6 +160,10 @@ signals :
 
     void end_preview_signal(QImage preview, SPCPage previewPage);
 
+    void end_preview_tile_signal(SPCPage previewPage, QSize pageSize, QRect tile, QImage image);
+
+    void end_page_thumbnail_signal(uint pageHash, QImage thumbnail);
+
     void end_generation_signal(bool finished);
 
     void abort_pdf_signal(QString pathPDF);
@@ -93,22 +176,98 @@ private :
 
     void draw_degraded(QPainter &painter, const QRectF &rectPage, const ColorsSettings &colors, const ExtraPCInfo &infos);
 
+    /**
+     * @brief Draw the backgrounds of the page from the cached layer, the layer is composed first if not cached
+     */
     void draw_backgrounds(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos);
 
+    void compose_backgrounds(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos);
+
     void draw_contents(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos);
 
+    /**
+     * @param [in] region part of the page to render, the whole page if empty
+     */
+    QImage render_page(const PCPages &pcPages, int pageIdToDraw, const QSizeF &size, qreal factorUpscale, bool drawZones, SPCPage &laidOutPage, const QRect &region = QRect());
+
+    /**
+     * @brief Return a hash of the page as exported: the inputs of page_hash with the export resolution and paper, the photos files dates and the texts with their tags replaced
+     * @param [in] documentInfos texts tags values common to all the pages, computed once per export
+     */
+    QByteArray export_hash(const PCPages &pcPages, int pageId, const ExtraPCInfo &documentInfos) const;
+
+    std::unique_ptr<QPagedPaintDevice> create_pdf_writer(const PCPages &pcPages, const QString &fileName) const;
+
+    /**
+     * @brief Render the page alone in a PDF file
+     */
+    bool export_page(const PCPages &pcPages, int pageId, const QString &fileName);
+
+    /**
+     * @brief Render the pages (id, file) in parallel by contiguous ranges, one range per core
+     */
+    bool export_pages(const PCPages &pcPages, const QVector<QPair<int,QString>> &pages);
+
+    /**
+     * @brief Return the cached layout of the formatted html for the given page size at the reference scale
+     */
+    QTextDocument *text_layout(const QString &html, const QSizeF &pageSize);
+
+private slots:
+
+    void generate_next_page_thumbnail();
+
+    void generate_next_preview_tiles();
+
 
 private :
 
     std::atomic_bool m_continueLoop{true};
+    Counter m_busyCounter;
     const int m_referenceDPI  = 100;
     int m_totalPC = 0;
 
-    SPCPage m_pageToDraw = nullptr;
-
-    std::unique_ptr<QTextDocument> m_doc = nullptr;
+    SPCPage m_pageToDraw = nullptr; /**< laid out copy of the last previewed page */
+    PCPages m_previewPages;         /**< snapshot of the last preview, the zoomed tiles are rendered from it */
+    int m_previewPageId = 0;
+    bool m_previewDrawZones = false;
+    qint64 m_layoutUs = 0, m_drawUs = 0; /**< stages time of the last rendered page */
+
+    // pages thumbnails
+    bool m_thumbnailScheduled = false;
+    PCPages m_thumbnailsPages;
+    QVector<int> m_thumbnailsPagesId;
+    QVector<uint> m_thumbnailsHash;
+
+    // preview tiles
+    bool m_tilesScheduled = false;
+    SPCPage m_tilesPage = nullptr;
+    QSize m_tilesPageSize;
+    QVector<QRect> m_tiles;
+
+    std::unique_ptr<QTextDocument> m_doc = nullptr;    /**< holds the text resources */
+    QCache<QString, QTextDocument> m_textLayouts{200}; /**< laid out texts by page size and html, children of m_doc */
+
+    // backgrounds
+    static constexpr int maxBackgroundLayers = 4;
+    QList<BackgroundLayer> m_backgroundLayers; /**< most recently used first */
+
+    // export
+    std::unique_ptr<QTemporaryDir> m_exportDir = nullptr;   /**< single page files of the exported pages */
+    QHash<const PCPage*, ExportedPage> m_exportedPages;     /**< pages of the last export */
+    int m_nbExportedFiles = 0;
+    qint64 m_resourcesBytes = 0;                            /**< bytes of the dropped and inserted images */
 
 public :
+
+    static constexpr int pageThumbnailSize = 96;
+    static constexpr int maxPreviewDPI = 300;
+
+    /**
+     * @brief Return the size in pixels of a page of the paper format rendered at the dpi
+     */
+    static QSizeF preview_size(const PaperFormat &paperFormat, qreal dpi);
+
     QVector<QImage> droppedImages;
     QVector<QUrl> droppedUrl;
 
@@ -37,6 +37,12 @@
 // local
 #include "Photo.hpp"
 #include "Utility.hpp"
+#include "FilePrefetcher.hpp"
+
+// Qt
+#include <QXmlStreamReader>
+
+Q_DECLARE_METATYPE(QXmlStreamAttributes)
 
 namespace pc {
 
@@ -48,27 +54,89 @@ public :
 
     PhotoLoaderWorker();
 
+    /**
+     * @brief Log the thumbnails decoding time of the photos of the directory with cold system cache,
+     * files read directly by the decoders against files read ahead by the prefetcher
+     */
+    static void benchmark_decoding(const QString &directory);
+
 public slots :
 
+    /**
+     * @brief Read only the headers of the photos files, the thumbnails are decoded afterwards in background
+     */
     void load_photos_directory(QStringList photosPath, int startIndexToInsert);
 
+    /**
+     * @brief Start of a directory scan, a loading stopped after the end of the previous scan is allowed again
+     */
+    void start_appending_photos();
+
+    /**
+     * @brief Read the headers of the photos found by a directory scan and append them, the batches are queued while reading
+     */
+    void append_photos(QStringList photosPath);
+
+    /**
+     * @brief End of the directory scan, sent once the last batch has been appended
+     */
+    void end_appending_photos();
+
+    /**
+     * @brief Create the photos of a work from their saved attributes, only the headers of the files are read, the thumbnails are decoded afterwards in background
+     */
+    void load_work_photos(QVector<QXmlStreamAttributes> photosAttributes);
+
+    /**
+     * @brief Add the photos not decoded yet to the thumbnails decoding queue (photos created only from their headers, e.g. from a work file)
+     */
+    void decode_thumbnails(SPhotos photos);
+
+    /**
+     * @brief Read again the headers and the EXIF metadata of the modified photos, the photos are copies not shared with the UI yet
+     */
+    void reload_photos(SPhotos photos);
+
+    /**
+     * @brief Move the given photos at the front of the thumbnails decoding queue (preview page first, then adjacent pages...)
+     */
+    void prioritize_photos(SPhotos photos);
+
     void kill();
 
+private slots :
+
+    void decode_next_thumbnail();
+
 signals :
 
     void set_progress_bar_state_signal(int state);
 
     void set_progress_bar_text_signal(QString text);
 
-    void photo_loaded_signal(SPhoto photo, int indexToInsert);
+    void photo_loaded_signal(SPhoto photo, int indexToInsert); /**< index of -1 to append at the end of the list */
 
     void end_loading_photos_signal();
 
+    void thumbnail_loaded_signal(SPhoto photo, QImage thumbnail);
+
+    void work_photos_loaded_signal(SPhotos photos);
+
+    void photos_reloaded_signal(SPhotos photos);
+
 
 private :
 
     QReadWriteLock m_locker;
     bool m_continueLoop = true;
+
+    bool m_readingHeaders = false;
+    bool m_decodingScheduled = false;
+    bool m_endOfAppending = false;
+    QStringList m_photosToAppend;                     /**< scanned paths waiting for their headers reading */
+    int m_nbAppended = 0, m_nbToAppend = 0;
+    QList<std::weak_ptr<Photo>> m_thumbnailsToDecode; /**< photos removed from the UI are skipped */
+    FilePrefetcher m_prefetcher;                      /**< reads the next files of the queue while the current batch is decoded */
 };
 
 }
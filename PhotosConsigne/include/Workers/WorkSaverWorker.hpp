@@ -0,0 +1,84 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+#pragma once
+
+/**
+ * \file WorkSaverWorker.hpp
+ * \brief defines WorkSaverWorker/WorkSnapshot
+ * \date 19/10/2026
+ */
+
+// local
+#include "Photo.hpp"
+#include "ResourceStore.hpp"
+
+// Qt
+#include <QUrl>
+
+namespace pc {
+
+    /**
+     * @brief Immutable copy of a work taken on the UI thread, serialized and written by the WorkSaverWorker
+     */
+    struct WorkSnapshot{
+
+        QString filePath;
+        bool binary = false;            /**< binary container (*.pcwork) or xml work */
+        QByteArray settings;            /**< xml of the document settings written from the widgets */
+        Photos photos;                  /**< copies of the photos */
+        QVector<QUrl> resourcesUrl;
+        QVector<QImage> resourcesImages;
+    };
+
+class WorkSaverWorker : public QObject{
+
+    Q_OBJECT
+
+public :
+
+    WorkSaverWorker(ResourceStore *resourceStore);
+
+public slots :
+
+    /**
+     * @brief Write the snapshot in a temporary file renamed at the end, a failed save never damages the previous work
+     */
+    void save_work(WorkSnapshot snapshot);
+
+signals :
+
+    void work_saved_signal(QString filePath, bool success);
+
+private :
+
+    bool save_xml(const WorkSnapshot &snapshot);
+    bool save_archive(const WorkSnapshot &snapshot);
+
+    ResourceStore *m_resourceStore = nullptr;
+};
+}
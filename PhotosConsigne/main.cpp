@@ -35,12 +35,16 @@
 
 // local
 #include "PCMainUI.hpp"
+#include "DebugMessage.hpp"
+#include "Trace.hpp"
+#include "PhotoLoaderWorker.hpp"
 
 // Qt
 #include <QApplication>
 #include <QTranslator>
 #include <QLibraryInfo>
 #include <QDesktopWidget>
+#include <QTimer>
 
 int main(int argc,char** argv)
 {    
@@ -58,9 +62,24 @@ int main(int argc,char** argv)
 
     QApplication app(argc, argv);
     app.installTranslator(&qtTranslator);
+    pc::StartupProfiler::start();
 
 
+    // measure the thumbnails decoding with cold system cache and quit
+    int benchmarkDecoding = app.arguments().indexOf("--benchmark-thumbnails-decoding");
+    if(benchmarkDecoding != -1 && benchmarkDecoding + 1 < app.arguments().size()){
+        pc::PhotoLoaderWorker::benchmark_decoding(app.arguments()[benchmarkDecoding+1]);
+        return 0;
+    }
+
     pc::PCMainUI w(&app);
+
+    // measure the pages rebuild cost and quit
+    if(app.arguments().contains("--benchmark-build-pages")){
+        w.benchmark_build_pages();
+        return 0;
+    }
+
     QDesktopWidget dw;
     QSize sizeWindow(1500,1100);
     QRect rectScreen = dw.availableGeometry();
@@ -76,5 +95,15 @@ int main(int argc,char** argv)
     w.resize(sizeWindow);
     w.show();
 
-    return app.exec();
+    // the first event loop iteration marks the window as interactive
+    QTimer::singleShot(0, &w, []{
+        pc::StartupProfiler::end("interactive");
+    });
+
+    int ret = app.exec();
+
+    // dump the recorded spans if PHOTOSCONSIGNE_TRACE is set
+    pc::Trace::write();
+
+    return ret;
 }
@@ -34,6 +34,7 @@
 
 // local
 #include "DocumentElements.hpp"
+#include "Trace.hpp"
 
 // Qt
 #include <QDebug>
@@ -42,11 +43,13 @@ using namespace pc;
 
 void pc::PCPage::compute_sizes(QRectF upperRect){
 
+    TraceSpan span("compute_sizes");
+
     rectOnPage = std::move(upperRect);
 
-    MarginsSettings &margins        = settings.margins;
-    MiscSettings &misc              = settings.misc;
-    SetsPositionSettings &positions = settings.positions;
+    const MarginsSettings &margins        = settings->margins;
+    const MiscSettings &misc              = settings->misc;
+    const SetsPositionSettings &positions = settings->positions;
 
     // extern margins
     qreal heightTopMargin = 0., heightBottomMargin = 0., widthLeftMargin = 0., widthRightMargin = 0.;
@@ -67,8 +70,8 @@ void pc::PCPage::compute_sizes(QRectF upperRect){
 
     // header/footer ratios
     qreal headerFooterSetsHeight = pageMinusMarginsRect.height() - footerMarginHeight - headerMarginHeight;
-    qreal footerRatio            = (footer->settings.enabled && !misc.doNotDisplayFooter) ? footer->settings.ratio : 0.;
-    qreal headerRatio            = (header->settings.enabled && !misc.doNotDisplayHeader) ? header->settings.ratio : 0.;
+    qreal footerRatio            = (footer->settings->enabled && !misc.doNotDisplayFooter) ? footer->settings->ratio : 0.;
+    qreal headerRatio            = (header->settings->enabled && !misc.doNotDisplayHeader) ? header->settings->ratio : 0.;
 
     qreal sum = footerRatio + headerRatio;
     if(sum > 1.){        
@@ -161,7 +164,7 @@ void pc::PCPage::compute_sizes(QRectF upperRect){
             if(currPC >= sets.size())
                 break;
 
-            QRectF &relRect = positions.relativePosCustom[ii];
+            const QRectF &relRect = positions.relativePosCustom[ii];
 
             sets[currPC]->compute_sizes(QRectF(setsRect.x() + relRect.x()*setsRect.width(),
                                                setsRect.y() + relRect.y()*setsRect.height(),
@@ -172,22 +175,36 @@ void pc::PCPage::compute_sizes(QRectF upperRect){
     }
 }
 
+SPCPage pc::PCPage::layout(const QRectF &pageRect) const{
+
+    SPCPage page = std::make_shared<PCPage>(*this);
+    page->header = std::make_shared<Header>(*header);
+    page->footer = std::make_shared<Footer>(*footer);
+    for(auto &&set : page->sets){
+        set = std::make_shared<PCSet>(*set);
+        set->text = std::make_shared<Consign>(*set->text);
+    }
+
+    page->compute_sizes(pageRect);
+    return page;
+}
+
 void pc::PCSet::compute_sizes(QRectF upperRect){
     rectOnPage = std::move(upperRect);
 
     //  text
-    qreal heightConsigneV = rectOnPage.height() * (1. - settings.style.ratioTextPhoto);
+    qreal heightConsigneV = rectOnPage.height() * (1. - settings->style.ratioTextPhoto);
     qreal widthConsigneV  = rectOnPage.width();
     qreal heightConsigneH = rectOnPage.height();
-    qreal widthConsigneH  = rectOnPage.width() * (1. - settings.style.ratioTextPhoto);
+    qreal widthConsigneH  = rectOnPage.width() * (1. - settings->style.ratioTextPhoto);
     //  photo
-    qreal heightPhotoV    = settings.style.ratioTextPhoto * rectOnPage.height();
+    qreal heightPhotoV    = settings->style.ratioTextPhoto * rectOnPage.height();
     qreal widthPhotoV     = rectOnPage.width();
     qreal heightPhotoH    = rectOnPage.height();
-    qreal widthPhotoH     = settings.style.ratioTextPhoto * rectOnPage.width();
+    qreal widthPhotoH     = settings->style.ratioTextPhoto * rectOnPage.width();
 
-    QRectF consignRect, photoRect;
-    switch (settings.style.textPositionFromPhotos) {
+    QRectF consignRect;
+    switch (settings->style.textPositionFromPhotos) {
     case Position::top:
         consignRect = QRectF(rectOnPage.x(), rectOnPage.y(), widthConsigneV, heightConsigneV);
         photoRect   = QRectF(rectOnPage.x(), rectOnPage.y() + heightConsigneV, widthPhotoV, heightPhotoV);
@@ -210,10 +227,46 @@ void pc::PCSet::compute_sizes(QRectF upperRect){
     }
 
     text->compute_sizes(consignRect);
-    photo->compute_sizes(photoRect);
 }
 
 
 void Header::compute_sizes(QRectF upperRect) {
     rectOnPage = std::move(upperRect);
 }
+
+uint pc::PCPages::page_hash(int index) const{
+
+    const SCPCPage &page = pages[index];
+
+    // # document
+    uint hash = qHash(index);
+    hash = qHash(static_cast<int>(settings.grayScale), hash);
+    hash = qHash(settings.paperFormat.ratioMM.width(), hash);
+    hash = qHash(settings.paperFormat.ratioMM.height(), hash);
+
+    // thumbnails may be decoded after the creation of the settings or of the set
+    auto hash_photo = [&](const Photo *photo){
+        if(photo != nullptr){
+            hash = qHash(photo->pathPhoto, hash);
+            hash = qHash(photo->rotation, hash);
+            hash = qHash(photo->scaledPhoto.cacheKey(), hash);
+        }
+    };
+
+    // # page
+    hash = qHash(page->settings->uid, hash);
+    hash = qHash(page->header->settings->uid, hash);
+    hash = qHash(page->footer->settings->uid, hash);
+    hash_photo(page->settings->background.photo.get());
+    hash_photo(page->header->settings->background.photo.get());
+    hash_photo(page->footer->settings->background.photo.get());
+
+    // # sets
+    for(const auto &set : page->sets){
+        hash = qHash(set->settings->uid, hash);
+        hash = qHash(set->totalId, hash);
+        hash_photo(set->photo.get());
+    }
+
+    return hash;
+}
@@ -0,0 +1,309 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file ExifReader.cpp
+ * \brief defines ExifReader
+ * \date 19/10/2026
+ */
+
+// local
+#include "ExifReader.hpp"
+
+// std
+#include <algorithm>
+
+// Qt
+#include <QFile>
+#include <QDebug>
+
+using namespace pc;
+
+QByteArray ExifReader::read_jpeg_exif_data(const QString &path, int maxSize){
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        return QByteArray();
+    }
+
+    // SOI
+    if(file.read(2) != QByteArray("\xFF\xD8", 2)){
+        return QByteArray();
+    }
+
+    // markers segments before the image data
+    while(true){
+
+        QByteArray marker = file.read(4);
+        if(marker.size() != 4 || static_cast<uchar>(marker[0]) != 0xFF){
+            return QByteArray();
+        }
+
+        uchar type = static_cast<uchar>(marker[1]);
+        if(type == 0xFF){ // fill byte
+            file.seek(file.pos()-3);
+            continue;
+        }
+
+        if(type == 0xDA || type == 0xD9){ // start of scan or end of image, no EXIF
+            return QByteArray();
+        }
+
+        int length = (static_cast<uchar>(marker[2]) << 8) | static_cast<uchar>(marker[3]);
+        if(length < 2){
+            return QByteArray();
+        }
+
+        if(type == 0xE1){ // APP1, can also be XMP
+
+            qint64 segmentStart = file.pos();
+            if(length >= 8 && file.peek(6) == QByteArray("Exif\0\0", 6)){
+                file.seek(segmentStart + 6);
+                return file.read((maxSize > 0) ? std::min(maxSize, length - 8) : length - 8);
+            }
+
+            if(!file.seek(segmentStart + length - 2)){
+                return QByteArray();
+            }
+            continue;
+        }
+
+        if(!file.seek(file.pos() + length - 2)){
+            return QByteArray();
+        }
+    }
+}
+
+QByteArray ExifReader::read_tiff_data(const QString &path, int maxSize){
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        return QByteArray();
+    }
+
+    return file.read(maxSize);
+}
+
+PhotoMetadata ExifReader::read_metadata(const QString &path){
+
+    constexpr int maxReadSize = 8 * 1024; // IFD0 and EXIF IFD are at the beginning, the thumbnail data is after
+
+    PhotoMetadata metadata;
+
+    QByteArray exif = read_jpeg_exif_data(path, maxReadSize);
+    if(exif.size() == 0){
+        exif = read_tiff_data(path, maxReadSize);
+    }
+
+    TiffData tiff(exif);
+    if(!tiff.valid()){
+        return metadata;
+    }
+
+    quint32 ifd0 = tiff.first_ifd_offset();
+
+    // IFD0
+    int entry = tiff.find_entry(ifd0, 0x0112); // Orientation
+    if(entry != -1){
+        int orientation = static_cast<int>(tiff.uint_value(entry));
+        if(orientation >= 1 && orientation <= 8){
+            metadata.orientation = orientation;
+        }
+    }
+
+    if((entry = tiff.find_entry(ifd0, 0x010F)) != -1){ // Make
+        metadata.cameraMake = QString::fromLatin1(tiff.ascii_value(entry)).trimmed();
+    }
+    if((entry = tiff.find_entry(ifd0, 0x0110)) != -1){ // Model
+        metadata.cameraModel = QString::fromLatin1(tiff.ascii_value(entry)).trimmed();
+    }
+
+    // # tiff files dimensions
+    int widthEntry  = tiff.find_entry(ifd0, 0x0100); // ImageWidth
+    int heightEntry = tiff.find_entry(ifd0, 0x0101); // ImageLength
+    if(widthEntry != -1 && heightEntry != -1){
+        metadata.dimensions = QSize(static_cast<int>(tiff.uint_value(widthEntry)), static_cast<int>(tiff.uint_value(heightEntry)));
+    }
+
+    QByteArray dateTime;
+    if((entry = tiff.find_entry(ifd0, 0x0132)) != -1){ // DateTime (last modification by the camera or a software)
+        dateTime = tiff.ascii_value(entry);
+    }
+
+    // EXIF IFD
+    if((entry = tiff.find_entry(ifd0, 0x8769)) != -1){ // ExifIFDPointer
+
+        quint32 exifIfd = tiff.uint_value(entry);
+
+        if((entry = tiff.find_entry(exifIfd, 0x9003)) != -1){ // DateTimeOriginal
+            dateTime = tiff.ascii_value(entry);
+        }
+
+        widthEntry  = tiff.find_entry(exifIfd, 0xA002); // PixelXDimension
+        heightEntry = tiff.find_entry(exifIfd, 0xA003); // PixelYDimension
+        if(widthEntry != -1 && heightEntry != -1){
+            metadata.dimensions = QSize(static_cast<int>(tiff.uint_value(widthEntry)), static_cast<int>(tiff.uint_value(heightEntry)));
+        }
+    }
+
+    if(dateTime.size() > 0){
+        metadata.captureTime = QDateTime::fromString(QString::fromLatin1(dateTime), "yyyy:MM:dd HH:mm:ss");
+    }
+
+    metadata.valid = true;
+    return metadata;
+}
+
+QImage ExifReader::read_embedded_thumbnail(const QString &path){
+
+    QByteArray exif = read_jpeg_exif_data(path);
+    TiffData tiff(exif);
+    if(!tiff.valid()){
+        return QImage();
+    }
+
+    // thumbnail is described in IFD1
+    quint32 ifd1 = tiff.next_ifd_offset(tiff.first_ifd_offset());
+    if(ifd1 == 0){
+        return QImage();
+    }
+
+    int offsetEntry = tiff.find_entry(ifd1, 0x0201); // JPEGInterchangeFormat
+    int lengthEntry = tiff.find_entry(ifd1, 0x0202); // JPEGInterchangeFormatLength
+    if(offsetEntry == -1 || lengthEntry == -1){
+        return QImage();
+    }
+
+    qint64 offset = tiff.u32(offsetEntry + 8);
+    qint64 length = tiff.u32(lengthEntry + 8);
+    if(length == 0 || offset + length > exif.size()){
+        return QImage();
+    }
+
+    return QImage::fromData(reinterpret_cast<const uchar*>(exif.constData() + offset), static_cast<int>(length), "JPG");
+}
+
+ExifReader::TiffData::TiffData(const QByteArray &data) : data(data){
+
+    if(data.size() < 8){
+        return;
+    }
+
+    if(data.startsWith("II")){
+        m_littleEndian = true;
+    }else if(data.startsWith("MM")){
+        m_littleEndian = false;
+    }else{
+        return;
+    }
+
+    m_valid = u16(2) == 42;
+}
+
+quint16 ExifReader::TiffData::u16(int offset) const{
+
+    if(offset < 0 || offset + 2 > data.size()){
+        return 0;
+    }
+
+    const uchar *d = reinterpret_cast<const uchar*>(data.constData()) + offset;
+    return m_littleEndian ? static_cast<quint16>(d[0] | (d[1] << 8)) : static_cast<quint16>((d[0] << 8) | d[1]);
+}
+
+quint32 ExifReader::TiffData::u32(int offset) const{
+
+    if(offset < 0 || offset + 4 > data.size()){
+        return 0;
+    }
+
+    const uchar *d = reinterpret_cast<const uchar*>(data.constData()) + offset;
+    return m_littleEndian ? (static_cast<quint32>(d[0]) | (static_cast<quint32>(d[1]) << 8) | (static_cast<quint32>(d[2]) << 16) | (static_cast<quint32>(d[3]) << 24)) :
+                            ((static_cast<quint32>(d[0]) << 24) | (static_cast<quint32>(d[1]) << 16) | (static_cast<quint32>(d[2]) << 8) | static_cast<quint32>(d[3]));
+}
+
+quint32 ExifReader::TiffData::next_ifd_offset(quint32 ifdOffset) const{
+
+    if(ifdOffset == 0 || ifdOffset + 2 > static_cast<quint32>(data.size())){
+        return 0;
+    }
+
+    return u32(static_cast<int>(ifdOffset + 2 + 12 * u16(static_cast<int>(ifdOffset))));
+}
+
+quint32 ExifReader::TiffData::uint_value(int entry) const{
+
+    switch(u16(entry + 2)){
+    case 3: // SHORT
+        return u16(entry + 8);
+    case 4: // LONG
+        return u32(entry + 8);
+    }
+
+    return 0;
+}
+
+QByteArray ExifReader::TiffData::ascii_value(int entry) const{
+
+    if(u16(entry + 2) != 2){ // ASCII
+        return QByteArray();
+    }
+
+    qint64 count  = u32(entry + 4);
+    qint64 offset = (count <= 4) ? entry + 8 : u32(entry + 8);
+    if(count == 0 || offset + count > data.size()){
+        return QByteArray();
+    }
+
+    QByteArray value = data.mid(static_cast<int>(offset), static_cast<int>(count));
+    int end = value.indexOf('\0');
+    if(end != -1){
+        value.truncate(end);
+    }
+
+    return value;
+}
+
+int ExifReader::TiffData::find_entry(quint32 ifdOffset, quint16 tag) const{
+
+    if(ifdOffset == 0 || ifdOffset + 2 > static_cast<quint32>(data.size())){
+        return -1;
+    }
+
+    int nbEntries = u16(static_cast<int>(ifdOffset));
+    for(int ii = 0; ii < nbEntries; ++ii){
+        int entry = static_cast<int>(ifdOffset) + 2 + 12 * ii;
+        if(entry + 12 > data.size()){
+            break;
+        }
+        if(u16(entry) == tag){
+            return entry;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,370 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file PdfMerger.cpp
+ * \brief defines PdfMerger
+ * \date 19/10/2026
+ */
+
+// local
+#include "PdfMerger.hpp"
+#include "Trace.hpp"
+
+// Qt
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QVector>
+
+// std
+#include <functional>
+
+using namespace pc;
+
+namespace {
+
+    /**
+     * @brief Objects of a PDF file addressed by their position in the file content
+     */
+    struct PdfFile{
+
+        QByteArray data;
+        QMap<int, QPair<int,int>> objects; /**< object number -> [begin, end[ of its content between "obj" and "endobj" */
+        int catalog   = -1;
+        int pagesTree = -1;
+        int info      = -1;
+        QVector<int> pages;
+
+        QByteArray object(int id) const{
+            auto position = objects.value(id, {0,0});
+            return data.mid(position.first, position.second - position.first);
+        }
+    };
+
+    const QRegularExpression referenceRegex("(?<![\\d.])(\\d+)\\s+0\\s+R\\b");
+
+    int reference(const QByteArray &dictionary, const QByteArray &key){
+        auto match = QRegularExpression("/" + key + "\\s+(\\d+)\\s+0\\s+R").match(QString::fromLatin1(dictionary));
+        return match.hasMatch() ? match.captured(1).toInt() : -1;
+    }
+
+    bool parse(const QString &path, PdfFile &file){
+
+        QFile pdf(path);
+        if(!pdf.open(QIODevice::ReadOnly)){
+            qWarning() << "-Error: PdfMerger -> can't read file: " << path;
+            return false;
+        }
+        file.data = pdf.readAll();
+        const QByteArray &data = file.data;
+
+        // cross-reference table
+        int startXref = data.lastIndexOf("startxref");
+        if(startXref == -1){
+            return false;
+        }
+        int xrefOffset = data.mid(startXref + 9, 32).trimmed().split('\n').first().trimmed().toInt();
+        if(xrefOffset <= 0 || !data.mid(xrefOffset, 4).startsWith("xref")){
+            qWarning() << "-Error: PdfMerger -> unsupported cross-reference in file: " << path;
+            return false;
+        }
+
+        int trailer = data.indexOf("trailer", xrefOffset);
+        if(trailer == -1){
+            return false;
+        }
+
+        QMap<int, int> offsets; // offset -> object number
+        QList<QByteArray> lines = data.mid(xrefOffset, trailer - xrefOffset).split('\n');
+        int currentId = 0;
+        for(int ii = 1; ii < lines.size(); ++ii){
+            QList<QByteArray> tokens = lines[ii].simplified().split(' ');
+            if(tokens.size() == 2){ // sub-section header
+                currentId = tokens[0].toInt();
+            }else if(tokens.size() == 3){
+                if(tokens[2] == "n"){
+                    offsets[tokens[0].toInt()] = currentId;
+                }
+                ++currentId;
+            }
+        }
+
+        // an object ends where the next one starts
+        for(auto it = offsets.begin(); it != offsets.end(); ++it){
+            int end = (it + 1 != offsets.end()) ? (it + 1).key() : xrefOffset;
+            int begin = data.indexOf("obj", it.key());
+            end = data.lastIndexOf("endobj", end);
+            if(begin == -1 || end < begin){
+                qWarning() << "-Error: PdfMerger -> invalid object " << it.value() << " in file: " << path;
+                return false;
+            }
+            file.objects[it.value()] = {begin + 3, end};
+        }
+
+        // pages
+        QByteArray trailerDictionary = data.mid(trailer, startXref - trailer);
+        file.catalog   = reference(trailerDictionary, "Root");
+        file.info      = reference(trailerDictionary, "Info");
+        file.pagesTree = reference(file.object(file.catalog), "Pages");
+
+        QByteArray pagesTree = file.object(file.pagesTree);
+        int kids = pagesTree.indexOf("/Kids");
+        if(kids == -1){
+            return false;
+        }
+        QByteArray kidsArray = pagesTree.mid(kids, pagesTree.indexOf(']', kids) - kids);
+        auto matches = referenceRegex.globalMatch(QString::fromLatin1(kidsArray));
+        while(matches.hasNext()){
+            file.pages << matches.next().captured(1).toInt();
+        }
+
+        return file.pages.size() > 0;
+    }
+
+    /**
+     * @brief New numbers of the objects of a merged file
+     */
+    struct Renumbering{
+
+        int shift = 0;
+        int oldPagesTree = -1;
+        int newPagesTree = -1;
+        QHash<int,int> duplicates; /**< objects identical to one already written -> its number */
+
+        int operator()(int id) const{
+            if(id == oldPagesTree){
+                return newPagesTree;
+            }
+            return duplicates.value(id, id + shift);
+        }
+    };
+
+    /**
+     * @brief Return the position of the stream keyword following the dictionary of the object, its size if there is no stream
+     */
+    int dictionary_end(const QByteArray &object){
+
+        int dictionaryEnd = object.indexOf("stream");
+        while(dictionaryEnd != -1){
+            int previous = dictionaryEnd - 1;
+            while(previous > 0 && QChar::fromLatin1(object[previous]).isSpace()){
+                --previous;
+            }
+            if(previous > 0 && object[previous] == '>' && object[previous-1] == '>'){
+                return dictionaryEnd;
+            }
+            dictionaryEnd = object.indexOf("stream", dictionaryEnd + 6);
+        }
+        return object.size();
+    }
+
+    /**
+     * @brief Return the dictionary of the object with each reference replaced by the given function result
+     */
+    QByteArray replace_references(const QByteArray &dictionary, std::function<QByteArray(int)> replacement){
+
+        QString text = QString::fromLatin1(dictionary);
+        QByteArray replaced;
+        int previousEnd = 0;
+        auto matches = referenceRegex.globalMatch(text);
+        while(matches.hasNext()){
+            auto match = matches.next();
+            replaced += text.midRef(previousEnd, match.capturedStart() - previousEnd).toLatin1();
+            replaced += replacement(match.captured(1).toInt());
+            previousEnd = match.capturedEnd();
+        }
+        replaced += text.midRef(previousEnd).toLatin1();
+        return replaced;
+    }
+
+    /**
+     * @brief Return the object with its references renumbered, only the dictionary is modified, the stream data is copied as is
+     */
+    QByteArray renumber(const QByteArray &object, const Renumbering &renumbering){
+
+        int dictionaryEnd = dictionary_end(object);
+        return replace_references(object.left(dictionaryEnd), [&](int id){
+            return QByteArray::number(renumbering(id)) + " 0 R";
+        }) + object.mid(dictionaryEnd);
+    }
+
+    /**
+     * @brief Find the images of the file already written by a previous file (backgrounds, photos repeated on several pages).
+     * An image is identified by its content with its references resolved: direct values (lengths) are inlined,
+     * images (soft masks) are replaced by their final number, so the images are resolved after the images they use.
+     */
+    void find_duplicated_images(const PdfFile &file, Renumbering &renumbering, QHash<QByteArray,int> &writtenImages){
+
+        QSet<int> unresolved;
+        for(auto it = file.objects.begin(); it != file.objects.end(); ++it){
+            QByteArray object = file.object(it.key());
+            if(object.left(dictionary_end(object)).contains("/Subtype /Image")){
+                unresolved.insert(it.key());
+            }
+        }
+
+        bool progress = true;
+        while(progress && unresolved.size() > 0){
+            progress = false;
+            for(int id : unresolved.toList()){
+
+                QByteArray object = file.object(id);
+                int dictionaryEnd = dictionary_end(object);
+
+                bool resolved = true;
+                QByteArray dictionary = replace_references(object.left(dictionaryEnd), [&](int reference){
+                    if(unresolved.contains(reference)){
+                        resolved = false;
+                    }
+                    QByteArray target = file.object(reference);
+                    if(dictionary_end(target) == target.size() && !referenceRegex.match(QString::fromLatin1(target)).hasMatch()){
+                        return target.trimmed();
+                    }
+                    return "#" + QByteArray::number(renumbering(reference));
+                });
+
+                if(!resolved){
+                    continue;
+                }
+
+                QCryptographicHash hash(QCryptographicHash::Sha1);
+                hash.addData(dictionary);
+                hash.addData(object.constData() + dictionaryEnd, object.size() - dictionaryEnd);
+                QByteArray key = hash.result();
+
+                auto written = writtenImages.find(key);
+                if(written != writtenImages.end()){
+                    renumbering.duplicates[id] = written.value();
+                }else{
+                    writtenImages[key] = renumbering(id);
+                }
+
+                unresolved.remove(id);
+                progress = true;
+            }
+        }
+    }
+}
+
+bool PdfMerger::merge(const QStringList &files, const QString &outputPath){
+
+    TraceSpan span("merge_pdf");
+
+    QSaveFile output(outputPath);
+    if(!output.open(QIODevice::WriteOnly)){
+        qWarning() << "-Error: PdfMerger -> can't write file: " << outputPath;
+        return false;
+    }
+
+    // objects 1 to 3 are the new catalog, pages tree and info
+    const int catalogId = 1, pagesTreeId = 2, infoId = 3;
+    QVector<qint64> offsets(infoId + 1, -1);
+    QVector<int> pages;
+    QByteArray info;
+    QHash<QByteArray,int> writtenImages; /**< content hash -> object number, shared images are written once */
+
+    output.write("%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+    for(const auto &path : files){
+
+        PdfFile file;
+        if(!parse(path, file)){
+            qWarning() << "-Error: PdfMerger -> can't merge file: " << path;
+            output.cancelWriting();
+            return false;
+        }
+
+        if(info.size() == 0 && file.info != -1){
+            info = file.object(file.info);
+        }
+
+        Renumbering renumbering;
+        renumbering.shift        = offsets.size() - 1;
+        renumbering.oldPagesTree = file.pagesTree;
+        renumbering.newPagesTree = pagesTreeId;
+        find_duplicated_images(file, renumbering, writtenImages);
+
+        offsets.resize(offsets.size() + file.objects.lastKey());
+        for(auto it = file.objects.begin(); it != file.objects.end(); ++it){
+
+            // the document objects of the file are replaced
+            if(it.key() == file.catalog || it.key() == file.pagesTree || it.key() == file.info || renumbering.duplicates.contains(it.key())){
+                continue;
+            }
+
+            offsets[renumbering(it.key())] = output.pos();
+            output.write(QByteArray::number(renumbering(it.key())) + " 0 obj");
+            output.write(renumber(file.object(it.key()), renumbering));
+            output.write("endobj\n");
+        }
+
+        for(int page : file.pages){
+            pages << renumbering(page);
+        }
+    }
+
+    QByteArray kids;
+    for(int page : pages){
+        kids += QByteArray::number(page) + " 0 R\n";
+    }
+
+    offsets[catalogId] = output.pos();
+    output.write("1 0 obj\n<<\n/Type /Catalog\n/Pages 2 0 R\n>>\nendobj\n");
+    offsets[pagesTreeId] = output.pos();
+    output.write("2 0 obj\n<<\n/Type /Pages\n/Kids\n[\n" + kids + "]\n/Count " + QByteArray::number(pages.size()) +
+                 "\n/ProcSet [/PDF /Text /ImageB /ImageC]\n>>\nendobj\n");
+    offsets[infoId] = output.pos();
+    output.write("3 0 obj" + (info.size() > 0 ? info : QByteArray("\n<<\n>>\n")) + "endobj\n");
+
+    // cross-reference table, the replaced objects are free entries linked from the object 0, the head of the free list
+    QVector<int> nextFree(offsets.size(), 0);
+    int previousFree = 0;
+    for(int ii = 1; ii < offsets.size(); ++ii){
+        if(offsets[ii] == -1){
+            nextFree[previousFree] = ii;
+            previousFree = ii;
+        }
+    }
+
+    qint64 xrefOffset = output.pos();
+    output.write("xref\n0 " + QByteArray::number(offsets.size()) + "\n");
+    output.write(QByteArray::number(nextFree[0]).rightJustified(10, '0') + " 65535 f \n");
+    for(int ii = 1; ii < offsets.size(); ++ii){
+        output.write(offsets[ii] == -1 ? QByteArray::number(nextFree[ii]).rightJustified(10, '0') + " 00001 f \n" :
+                                         QByteArray::number(offsets[ii]).rightJustified(10, '0') + " 00000 n \n");
+    }
+    output.write("trailer\n<<\n/Size " + QByteArray::number(offsets.size()) + "\n/Info 3 0 R\n/Root 1 0 R\n>>\nstartxref\n" +
+                 QByteArray::number(xrefOffset) + "\n%%EOF\n");
+
+    return output.commit();
+}
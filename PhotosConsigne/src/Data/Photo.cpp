@@ -34,10 +34,14 @@
  */
 
 // Qt
+#include <QBuffer>
 #include <QDebug>
+#include <QImageReader>
 
 // local
 #include "Photo.hpp"
+#include "ExifReader.hpp"
+#include "Trace.hpp"
 
 
 using namespace pc;
@@ -46,28 +50,46 @@ pc::Photo::Photo(QImage image){
 
     scaledPhoto  = image;
     originalSize = scaledPhoto.size();
+    isLoaded     = true;
+    thumbnailBytes.update(scaledPhoto);
 }
 
-pc::Photo::Photo(const QString &path, bool isWhiteSpace) : isWhiteSpace(isWhiteSpace), pathPhoto(path){
-
-    constexpr int maxHeight = 800;
-    constexpr int maxWidth  = 800;
+pc::Photo::Photo(const QString &path, bool isWhiteSpace, bool loadThumbnail) : isWhiteSpace(isWhiteSpace), pathPhoto(path){
 
     if(isWhiteSpace){
         namePhoto = "Espace transparent";
+        isLoaded  = true;
     }else{
 
-        info            = QFileInfo(path);
-        scaledPhoto     = QImage(path);
-        originalSize    = scaledPhoto.size();
+        TraceSpan span("read_photo_header");
+        info         = QFileInfo(path);
+        lastModified = info.lastModified();
+
+        // read only the header
+        QImageReader reader(path);
+        originalSize    = reader.size();
+        format          = reader.format();
+        transformation  = reader.transformation();
+
+        if(!originalSize.isValid() && reader.canRead()){ // handler can't give the size without decoding
+            QImage image = reader.read();
+            originalSize = image.size();
+            if(!image.isNull()){
+                set_thumbnail(image.size().width() > thumbnailMaxWidth || image.size().height() > thumbnailMaxHeight ?
+                                  image.scaled(thumbnailMaxWidth, thumbnailMaxHeight, Qt::KeepAspectRatio) : image);
+            }
+        }
 
-        if(!scaledPhoto.isNull()){
+        if(originalSize.isValid()){
 
             namePhoto = pathPhoto.split('/').last().split('.').first();
-            if(scaledPhoto.size().width() > maxWidth)
-                scaledPhoto = scaledPhoto.scaledToWidth(maxWidth);
-            if(scaledPhoto.size().height() > maxHeight)
-                scaledPhoto = scaledPhoto.scaledToHeight(maxHeight);
+            if(loadThumbnail && !isLoaded){
+                set_thumbnail(read_thumbnail(path));
+            }else if(!isLoaded){
+                // display the embedded camera thumbnail until the real one is decoded
+                scaledPhoto = read_embedded_thumbnail(path, originalSize);
+                thumbnailBytes.update(scaledPhoto);
+            }
         }
         else{
             namePhoto = "Erreur";
@@ -76,19 +98,142 @@ pc::Photo::Photo(const QString &path, bool isWhiteSpace) : isWhiteSpace(isWhiteS
     }
 }
 
-void pc::Photo::draw(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const ExtraPCInfo &infos, const QSizeF &pageSize){
+pc::Photo::Photo(const QString &path, QSize originalSize, QByteArray format, QImageIOHandler::Transformations transformation) :
+    originalSize(originalSize), format(format), transformation(transformation), pathPhoto(path){
 
-    if(isWhiteSpace){
+    info         = QFileInfo(path);
+    lastModified = info.lastModified();
+    namePhoto    = pathPhoto.split('/').last().split('.').first();
+}
+
+QImage pc::Photo::read_thumbnail(const QString &path){
+    return read_thumbnail(path, QByteArray());
+}
+
+QImage pc::Photo::read_thumbnail(const QString &path, const QByteArray &data){
+
+    TraceSpan span("decode_thumbnail");
+
+    QBuffer buffer;
+    QImageReader reader;
+    if(data.size() > 0){
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        reader.setDevice(&buffer);
+        reader.setDecideFormatFromContent(true);
+    }else{
+        reader.setFileName(path);
+    }
+
+    QSize size = reader.size();
+    if(size.width() > thumbnailMaxWidth || size.height() > thumbnailMaxHeight){
+        reader.setScaledSize(size.scaled(thumbnailMaxWidth, thumbnailMaxHeight, Qt::KeepAspectRatio));
+    }
+
+    QImage thumbnail = reader.read();
+    if(thumbnail.isNull()){
+        qWarning() << "-Error: thumbnail not decoded: " << path << reader.errorString();
+    }
+
+    return thumbnail;
+}
+
+QImage pc::Photo::read_embedded_thumbnail(const QString &path, const QSize &originalSize){
+
+    QImage thumbnail = ExifReader::read_embedded_thumbnail(path);
+    if(thumbnail.isNull() || originalSize.isEmpty()){
+        return thumbnail;
+    }
+
+    // remove the black bands added by the camera when the thumbnail ratio differs from the photo one
+    QSize size = originalSize.scaled(thumbnail.size(), Qt::KeepAspectRatio);
+    if(size.width() < thumbnail.width() || size.height() < thumbnail.height()){
+        thumbnail = thumbnail.copy((thumbnail.width()-size.width())/2, (thumbnail.height()-size.height())/2, size.width(), size.height());
+    }
+
+    return thumbnail;
+}
+
+void pc::Photo::set_thumbnail(QImage thumbnail){
+
+    scaledPhoto = (rotation != 0) ? thumbnail.transformed(QTransform().rotate(rotation)) : std::move(thumbnail);
+    isLoaded    = true;
+    thumbnailBytes.update(scaledPhoto);
+    ++version;
+}
+
+void pc::Photo::rotate(int angle){
+
+    rotation    = (rotation + angle)%360;
+    scaledPhoto = scaledPhoto.transformed(QTransform().rotate(angle));
+    thumbnailBytes.update(scaledPhoto);
+    ++version;
+}
+
+pc::SCPhoto pc::Photo::snapshot() const{
+
+    // the modification date is read at the import and at the reload, the file is not accessed here
+    return std::make_shared<const Photo>(*this);
+}
+
+quint64 pc::Photo::new_uid(){
+    static std::atomic<quint64> counter{0};
+    return ++counter;
+}
+
+void pc::Photo::reload_header(){
+
+    info         = QFileInfo(pathPhoto);
+    lastModified = info.lastModified();
+
+    QImageReader reader(pathPhoto);
+    if(reader.size().isValid()){
+        originalSize   = reader.size();
+        format         = reader.format();
+        transformation = reader.transformation();
+    }
+    isLoaded = false;
+    ++version;
+}
+
+void pc::Photo::set_metadata(PhotoMetadata photoMetadata, bool applyOrientation){
+
+    metadata = std::move(photoMetadata);
+    ++version;
+    if(!applyOrientation || metadata.rotation() == rotation){
         return;
     }
 
-    if(scaledPhoto.isNull()){
-        qWarning() << "-Error: photo is null, can't be drawn";
+    int angle = metadata.rotation() - rotation;
+    rotation  = metadata.rotation();
+    if(!scaledPhoto.isNull()){
+        scaledPhoto = scaledPhoto.transformed(QTransform().rotate(angle));
+        thumbnailBytes.update(scaledPhoto);
+    }
+}
+
+QSize pc::Photo::scaled_size() const noexcept{
+
+    if(isLoaded){
+        return scaledPhoto.size();
+    }
+
+    QSize size = originalSize;
+    if(size.width() > thumbnailMaxWidth || size.height() > thumbnailMaxHeight){
+        size = size.scaled(thumbnailMaxWidth, thumbnailMaxHeight, Qt::KeepAspectRatio);
+    }
+
+    return (rotation % 180 != 0) ? size.transposed() : size;
+}
+
+void pc::Photo::draw(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const ExtraPCInfo &infos, const QSizeF &pageSize) const{
+
+    if(isWhiteSpace){
         return;
     }
 
     if(infos.preview){
-        draw_small(painter, position, rectPhoto, scaledPhoto, infos, pageSize);
+        draw_prepared(painter, prepare_preview(position, rectPhoto, infos), infos, pageSize);
     }else{
         if(rectPhoto.width() > 32000 || rectPhoto.height() > 32000){
 //            draw_huge(painter, rectPhoto);
@@ -99,7 +244,9 @@ void pc::Photo::draw(QPainter &painter, const ImagePositionSettings &position, c
     }
 }
 
-QRectF pc::Photo::draw_small(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos, const QSizeF &pageSize){
+pc::PreparedPhoto pc::Photo::prepare_small(const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos) const{
+
+    TraceSpan span("prepare_small");
 
     int startX, startY;
     qreal newX =0., newY =0., newWidth =0., newHeight =0.;
@@ -175,12 +322,9 @@ QRectF pc::Photo::draw_small(QPainter &painter, const ImagePositionSettings &pos
         break;
         case PhotoAdjust::mosaic:
 
-            QSize scaledSize(infos.factorUpscale* position.scale*photo.width(), infos.factorUpscale*position.scale*photo.height());
-
-            if(!infos.preview){
-                scaledSize.setWidth(scaledSize.width() *(1.*scaledPhoto.width()/photo.width()));
-                scaledSize.setHeight(scaledSize.height() *(1.*scaledPhoto.height()/photo.height()));
-            }
+            // tiles size is always defined from the thumbnail size, whatever the resolution of the photo to draw
+            QSize thumbnailSize = scaled_size();
+            QSize scaledSize(infos.factorUpscale* position.scale*thumbnailSize.width(), infos.factorUpscale*position.scale*thumbnailSize.height());
 
             QImage tile = photo.scaled(scaledSize, Qt::IgnoreAspectRatio);
             if(tile.width() > rectPhoto.width() || tile.height() > rectPhoto.height()){
@@ -229,8 +373,19 @@ QRectF pc::Photo::draw_small(QPainter &painter, const ImagePositionSettings &pos
     }
 
 
+    return {photoToDraw, QRectF(newX, newY, newWidth, newHeight)};
+}
+
+void pc::Photo::draw_prepared(QPainter &painter, const PreparedPhoto &prepared, const ExtraPCInfo &infos, const QSizeF &pageSize) const{
+
+    if(prepared.image.isNull()){
+        return;
+    }
+
     // draw image
-    QRectF newRectPhoto(newX, newY, newWidth, newHeight);
+    const QImage &photoToDraw = prepared.image;
+    const QRectF &newRectPhoto = prepared.rect;
+    qreal newX = newRectPhoto.x(), newY = newRectPhoto.y(), newWidth = newRectPhoto.width(), newHeight = newRectPhoto.height();
 
     // ########### TEST
 //    qreal square = std::min(newRectPhoto.right()-newRectPhoto.left(), newRectPhoto.bottom()-newRectPhoto.top());
@@ -260,8 +415,38 @@ QRectF pc::Photo::draw_small(QPainter &painter, const ImagePositionSettings &pos
         painter.setFont(font);
         painter.drawText(QRectF(newX, newY, newWidth, newHeight),  Qt::AlignCenter,sizeImageStr);
     }
+}
+
+QRectF pc::Photo::draw_small(QPainter &painter, const ImagePositionSettings &position, const QRectF &rectPhoto, const QImage &photo, const ExtraPCInfo &infos, const QSizeF &pageSize) const{
+
+    TraceSpan span("draw_small");
+
+    PreparedPhoto prepared = prepare_small(position, rectPhoto, photo, infos);
+    draw_prepared(painter, prepared, infos, pageSize);
+    return prepared.rect;
+}
+
+pc::PreparedPhoto pc::Photo::prepare_preview(const ImagePositionSettings &position, const QRectF &rectPhoto, const ExtraPCInfo &infos) const{
+
+    if(isWhiteSpace){
+        return {};
+    }
+
+    if(!isLoaded && scaledPhoto.isNull()){ // thumbnail not decoded yet and no embedded one, draw a placeholder with the same ratio
+        QImage placeholder(scaled_size().scaled(64, 64, Qt::KeepAspectRatio), QImage::Format_RGB32);
+        if(placeholder.isNull()){
+            return {};
+        }
+        placeholder.fill(qRgb(225,225,225));
+        return prepare_small(position, rectPhoto, placeholder, infos);
+    }
+
+    if(scaledPhoto.isNull()){
+        qWarning() << "-Error: photo is null, can't be drawn";
+        return {};
+    }
 
-    return newRectPhoto;
+    return prepare_small(position, rectPhoto, scaledPhoto, infos);
 }
 
 
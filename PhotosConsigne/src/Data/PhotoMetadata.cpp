@@ -0,0 +1,103 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file PhotoMetadata.cpp
+ * \brief defines PhotoMetadata/MetadataIndex
+ * \date 19/10/2026
+ */
+
+// local
+#include "PhotoMetadata.hpp"
+#include "ExifReader.hpp"
+
+// Qt
+#include <QtConcurrent>
+
+using namespace pc;
+
+QReadWriteLock MetadataIndex::m_locker;
+QHash<QString, PhotoMetadata> MetadataIndex::m_metadata;
+
+void MetadataIndex::index(const QStringList &paths){
+
+    QStringList toRead;
+    m_locker.lockForRead();
+    for(const auto &path : paths){
+        if(!m_metadata.contains(path)){
+            toRead << path;
+        }
+    }
+    m_locker.unlock();
+
+    if(toRead.size() == 0){
+        return;
+    }
+
+    // headers reads are short and independant, the global threads pool overlaps their IO
+    QList<PhotoMetadata> metadata = QtConcurrent::blockingMapped<QList<PhotoMetadata>>(toRead, &ExifReader::read_metadata);
+
+    QWriteLocker locker(&m_locker);
+    for(int ii = 0; ii < toRead.size(); ++ii){
+        m_metadata[toRead[ii]] = metadata[ii];
+    }
+}
+
+void MetadataIndex::reindex(const QStringList &paths){
+
+    m_locker.lockForWrite();
+    for(const auto &path : paths){
+        m_metadata.remove(path);
+    }
+    m_locker.unlock();
+
+    index(paths);
+}
+
+PhotoMetadata MetadataIndex::get(const QString &path){
+
+    m_locker.lockForRead();
+    auto it = m_metadata.constFind(path);
+    if(it != m_metadata.constEnd()){
+        PhotoMetadata metadata = it.value();
+        m_locker.unlock();
+        return metadata;
+    }
+    m_locker.unlock();
+
+    PhotoMetadata metadata = ExifReader::read_metadata(path);
+    QWriteLocker locker(&m_locker);
+    m_metadata[path] = metadata;
+    return metadata;
+}
+
+void MetadataIndex::clear(){
+
+    QWriteLocker locker(&m_locker);
+    m_metadata.clear();
+}
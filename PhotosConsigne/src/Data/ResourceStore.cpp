@@ -0,0 +1,155 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+/**
+ * \file ResourceStore.cpp
+ * \brief defines ResourceStore
+ * \date 19/10/2026
+ */
+
+// local
+#include "ResourceStore.hpp"
+#include "Counters.hpp"
+
+// Qt
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+using namespace pc;
+
+QString ResourceStore::content_key(const QImage &image){
+
+    m_locker.lock();
+    auto key = m_keys.constFind(image.cacheKey());
+    if(key != m_keys.constEnd()){
+        QString contentKey = key.value();
+        m_locker.unlock();
+        Counters::add(Counter::ResourceKeysHits);
+        return contentKey;
+    }
+    m_locker.unlock();
+    Counters::add(Counter::ResourceKeysMisses);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream << image.width() << image.height() << static_cast<int>(image.format()) << image.colorTable();
+    hash.addData(header);
+    for(int ii = 0; ii < image.height(); ++ii){ // lines only, the padding is not part of the content
+        hash.addData(reinterpret_cast<const char*>(image.constScanLine(ii)), (image.width()*image.depth() + 7)/8);
+    }
+
+    QString contentKey = hash.result().toHex();
+    QMutexLocker locker(&m_locker);
+    m_keys[image.cacheKey()] = contentKey;
+    return contentKey;
+}
+
+QString ResourceStore::store(const QString &dirPath, const QImage &image){
+
+    QString path = dirPath + "/" + content_key(image) + ".png";
+    if(QFileInfo::exists(path)){ // already written
+        return path;
+    }
+
+    // write a temporary file first, an interrupted save never leaves a truncated resource under its final name
+    QString tempPath = path + ".tmp";
+    if(!image.save(tempPath, "PNG")){
+        qWarning() << "-Error: ResourceStore::store -> cannot write " << tempPath;
+        QFile::remove(tempPath);
+        return "";
+    }
+    if(!QFile::rename(tempPath, path)){
+        qWarning() << "-Error: ResourceStore::store -> cannot rename " << tempPath;
+        QFile::remove(tempPath);
+        return "";
+    }
+
+    return path;
+}
+
+QByteArray ResourceStore::png_data(const QImage &image){
+
+    QString key = content_key(image);
+    m_locker.lock();
+    auto data = m_pngData.constFind(key);
+    if(data != m_pngData.constEnd()){
+        QByteArray pngData = data.value();
+        m_locker.unlock();
+        return pngData;
+    }
+    m_locker.unlock();
+
+    QByteArray pngData;
+    QBuffer buffer(&pngData);
+    buffer.open(QIODevice::WriteOnly);
+    if(!image.save(&buffer, "PNG")){
+        qWarning() << "-Error: ResourceStore::png_data -> cannot encode image " << key;
+        return QByteArray();
+    }
+
+    QMutexLocker locker(&m_locker);
+    m_pngData[key] = pngData;
+    return pngData;
+}
+
+void ResourceStore::register_resource(const QImage &image, const QString &path){
+
+    QString name = QFileInfo(path).completeBaseName();
+    if(name.size() == 40){ // sha1 file name
+        QMutexLocker locker(&m_locker);
+        m_keys[image.cacheKey()] = name;
+    }
+}
+
+void ResourceStore::register_content(const QImage &image, const QString &contentKey, const QByteArray &pngData){
+
+    QMutexLocker locker(&m_locker);
+    m_keys[image.cacheKey()] = contentKey;
+    if(!pngData.isEmpty()){
+        m_pngData[contentKey] = pngData;
+    }
+}
+
+int ResourceStore::collect_garbage(const QString &dirPath, const QSet<QString> &usedFilesNames){
+
+    int nbRemoved = 0;
+    QDir dir(dirPath);
+    for(const auto &fileName : dir.entryList({"*.png", "*.png.tmp"}, QDir::Files)){
+        if(!usedFilesNames.contains(fileName)){
+            if(dir.remove(fileName)){
+                ++nbRemoved;
+            }
+        }
+    }
+
+    return nbRemoved;
+}
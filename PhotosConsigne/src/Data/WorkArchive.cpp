@@ -0,0 +1,299 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+/**
+ * \file WorkArchive.cpp
+ * \brief defines WorkArchive/WorkArchiveContent
+ * \date 19/10/2026
+ */
+
+// local
+#include "WorkArchive.hpp"
+
+// Qt
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <QDebug>
+
+// std
+#include <algorithm>
+
+using namespace pc;
+
+static constexpr QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+
+bool WorkArchive::is_archive(const QString &path){
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    quint32 fileMagic = 0;
+    stream >> fileMagic;
+    return fileMagic == magic;
+}
+
+QByteArray WorkArchive::encode_thumbnail(const SPhoto &photo){
+
+    if(photo->isWhiteSpace || photo->scaledPhoto.isNull()){
+        return QByteArray();
+    }
+
+    QImage thumbnail = photo->scaledPhoto;
+    if(thumbnail.width() > thumbnailSize || thumbnail.height() > thumbnailSize){
+        thumbnail = thumbnail.scaled(thumbnailSize, thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    thumbnail.save(&buffer, "JPG", 85);
+    return data;
+}
+
+QImage WorkArchive::decode_thumbnail(const QByteArray &data){
+
+    if(data.isEmpty()){
+        return QImage();
+    }
+    return QImage::fromData(data, "JPG");
+}
+
+bool WorkArchive::save(const QString &path, const WorkArchiveContent &content){
+
+    QVector<QByteArray> sections(4);
+
+    // # settings
+    sections[static_cast<int>(Section::Settings)] = qCompress(content.settings);
+
+    // # photos
+    {
+        QDataStream stream(&sections[static_cast<int>(Section::Photos)], QIODevice::WriteOnly);
+        stream.setVersion(streamVersion);
+        stream << static_cast<quint32>(content.photos->size());
+        for(const auto &photo : *content.photos){
+            stream << photo->pathPhoto << photo->isWhiteSpace << photo->isADuplicate << photo->isOnDocument << photo->isRemoved
+                   << static_cast<qint32>(photo->id) << static_cast<qint32>(photo->pageId) << static_cast<qint32>(photo->loadedId)
+                   << static_cast<qint32>(photo->rotation) << photo->originalSize << photo->format << static_cast<qint32>(photo->transformation);
+
+            const PhotoMetadata &metadata = photo->metadata;
+            stream << metadata.valid << metadata.captureTime << static_cast<qint32>(metadata.orientation) << metadata.dimensions
+                   << metadata.cameraMake << metadata.cameraModel;
+        }
+    }
+
+    // # thumbnails, encoded in parallel, an index of sizes is followed by the data
+    {
+        QList<QByteArray> thumbnails = QtConcurrent::blockingMapped<QList<QByteArray>>(*content.photos, &WorkArchive::encode_thumbnail);
+
+        QDataStream stream(&sections[static_cast<int>(Section::Thumbnails)], QIODevice::WriteOnly);
+        stream.setVersion(streamVersion);
+        stream << static_cast<quint32>(thumbnails.size());
+        for(const auto &thumbnail : thumbnails){
+            stream << static_cast<quint32>(thumbnail.size());
+        }
+        for(const auto &thumbnail : thumbnails){
+            stream.writeRawData(thumbnail.constData(), thumbnail.size());
+        }
+    }
+
+    // # resources
+    {
+        QDataStream stream(&sections[static_cast<int>(Section::Resources)], QIODevice::WriteOnly);
+        stream.setVersion(streamVersion);
+        stream << static_cast<quint32>(content.resourcesUrl.size());
+        for(int ii = 0; ii < content.resourcesUrl.size(); ++ii){
+            stream << content.resourcesUrl[ii] << content.resourcesKey[ii] << content.resourcesData[ii];
+        }
+    }
+
+    // written in a temporary file renamed at the end
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly)){
+        qWarning() << "-Error: WorkArchive::save -> cannot open " << path;
+        return false;
+    }
+
+    // # header: magic, version and sections table
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    stream << magic << formatVersion << static_cast<quint32>(sections.size());
+
+    quint64 offset = 3*sizeof(quint32) + sections.size()*(sizeof(quint32) + 2*sizeof(quint64));
+    for(int ii = 0; ii < sections.size(); ++ii){
+        stream << static_cast<quint32>(ii) << offset << static_cast<quint64>(sections[ii].size());
+        offset += sections[ii].size();
+    }
+    for(const auto &section : sections){
+        stream.writeRawData(section.constData(), section.size());
+    }
+
+    if(stream.status() != QDataStream::Ok){
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool WorkArchive::load(const QString &path, WorkArchiveContent &content){
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        qWarning() << "-Error: WorkArchive::load -> cannot open " << path;
+        return false;
+    }
+
+    uchar *map = file.map(0, file.size());
+    if(map == nullptr){
+        qWarning() << "-Error: WorkArchive::load -> cannot map " << path;
+        return false;
+    }
+
+    // sections point directly in the mapped file
+    QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char*>(map), static_cast<int>(file.size()));
+    QDataStream headerStream(header);
+    headerStream.setVersion(streamVersion);
+
+    quint32 fileMagic = 0, fileVersion = 0, nbSections = 0;
+    headerStream >> fileMagic >> fileVersion >> nbSections;
+    if(fileMagic != magic || fileVersion > formatVersion){
+        qWarning() << "-Error: WorkArchive::load -> unsupported file " << path << fileVersion;
+        file.unmap(map);
+        return false;
+    }
+
+    QVector<QByteArray> sections(4);
+    for(quint32 ii = 0; ii < nbSections; ++ii){
+        quint32 id;
+        quint64 offset, size;
+        headerStream >> id >> offset >> size;
+        if(id < static_cast<quint32>(sections.size()) && offset + size <= static_cast<quint64>(file.size())){ // unknown sections of newer versions are skipped
+            sections[static_cast<int>(id)] = QByteArray::fromRawData(reinterpret_cast<const char*>(map + offset), static_cast<int>(size));
+        }
+    }
+
+    // # settings
+    content.settings = qUncompress(sections[static_cast<int>(Section::Settings)]);
+
+    // # photos
+    content.photos = std::make_shared<Photos>();
+    {
+        QDataStream stream(sections[static_cast<int>(Section::Photos)]);
+        stream.setVersion(streamVersion);
+        quint32 nbPhotos = 0;
+        stream >> nbPhotos;
+        // the count comes from the file, an entry takes at least minPhotoEntrySize bytes of the section
+        const quint32 minPhotoEntrySize = 64;
+        content.photos->reserve(static_cast<int>(std::min<quint64>(nbPhotos, static_cast<quint64>(sections[static_cast<int>(Section::Photos)].size()) / minPhotoEntrySize)));
+        for(quint32 ii = 0; ii < nbPhotos && stream.status() == QDataStream::Ok; ++ii){
+
+            QString pathPhoto;
+            bool isWhiteSpace, isADuplicate, isOnDocument, isRemoved;
+            qint32 id, pageId, loadedId, rotation, transformation;
+            QSize originalSize;
+            QByteArray format;
+            stream >> pathPhoto >> isWhiteSpace >> isADuplicate >> isOnDocument >> isRemoved
+                   >> id >> pageId >> loadedId >> rotation >> originalSize >> format >> transformation;
+
+            PhotoMetadata metadata;
+            qint32 orientation;
+            stream >> metadata.valid >> metadata.captureTime >> orientation >> metadata.dimensions >> metadata.cameraMake >> metadata.cameraModel;
+            metadata.orientation = orientation;
+
+            SPhoto photo = isWhiteSpace ? std::make_shared<Photo>(pathPhoto, true) :
+                                          std::make_shared<Photo>(pathPhoto, originalSize, format, static_cast<QImageIOHandler::Transformations>(transformation));
+            photo->isADuplicate = isADuplicate;
+            photo->isOnDocument = isOnDocument;
+            photo->isRemoved    = isRemoved;
+            photo->id           = id;
+            photo->pageId       = pageId;
+            photo->loadedId     = loadedId;
+            photo->rotation     = rotation;
+            photo->set_metadata(metadata, false);
+            content.photos->push_back(photo);
+        }
+    }
+
+    // # thumbnails, decoded in parallel from the mapped data, they are only placeholders until the full decoding
+    {
+        const QByteArray &section = sections[static_cast<int>(Section::Thumbnails)];
+        QDataStream stream(section);
+        stream.setVersion(streamVersion);
+        quint32 nbThumbnails = 0;
+        stream >> nbThumbnails;
+
+        QList<QByteArray> thumbnailsData;
+        quint64 offset = sizeof(quint32)*(1 + nbThumbnails);
+        for(quint32 ii = 0; ii < nbThumbnails && stream.status() == QDataStream::Ok; ++ii){
+            quint32 size;
+            stream >> size;
+            thumbnailsData << ((offset + size <= static_cast<quint64>(section.size())) ?
+                                   QByteArray::fromRawData(section.constData() + offset, static_cast<int>(size)) : QByteArray());
+            offset += size;
+        }
+
+        QList<QImage> thumbnails = QtConcurrent::blockingMapped<QList<QImage>>(thumbnailsData, &WorkArchive::decode_thumbnail);
+        for(int ii = 0; ii < std::min(thumbnails.size(), content.photos->size()); ++ii){
+            if(!content.photos->at(ii)->isWhiteSpace){
+                content.photos->at(ii)->scaledPhoto = thumbnails[ii]; // already rotated
+                content.photos->at(ii)->thumbnailBytes.update(thumbnails[ii]);
+            }
+        }
+    }
+
+    // # resources
+    {
+        QDataStream stream(sections[static_cast<int>(Section::Resources)]);
+        stream.setVersion(streamVersion);
+        quint32 nbResources = 0;
+        stream >> nbResources;
+        for(quint32 ii = 0; ii < nbResources && stream.status() == QDataStream::Ok; ++ii){
+
+            QUrl url;
+            QString key;
+            QByteArray data;
+            stream >> url >> key >> data;
+
+            QImage image = QImage::fromData(data, "PNG");
+            if(!image.isNull()){
+                content.resourcesUrl    << url;
+                content.resourcesKey    << key;
+                content.resourcesData   << data;
+                content.resourcesImages << image;
+            }
+        }
+    }
+
+    file.unmap(map);
+    return true;
+}
@@ -0,0 +1,151 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file Trace.cpp
+ * \brief defines Trace
+ * \date 19/10/2026
+ */
+
+// local
+#include "Trace.hpp"
+
+// Qt
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+// std
+#include <utility>
+
+using namespace pc;
+
+namespace{
+
+    struct TraceEvent{
+        const char *name;
+        qint64 start;
+        qint64 duration;
+        quintptr threadId;
+    };
+
+    struct TraceRecorder{
+
+        TraceRecorder() : filePath(QString::fromLocal8Bit(qgetenv("PHOTOSCONSIGNE_TRACE"))){
+            enabled = filePath.size() > 0;
+            if(enabled){
+                timer.start();
+            }
+        }
+
+        bool enabled = false;
+        QString filePath;
+        QElapsedTimer timer;
+
+        QMutex locker;
+        QVector<TraceEvent> events;
+        QHash<quintptr, QString> threadsName;
+    };
+
+    TraceRecorder &recorder(){
+        static TraceRecorder traceRecorder;
+        return traceRecorder;
+    }
+}
+
+bool Trace::enabled() noexcept{
+    static const bool traceEnabled = recorder().enabled;
+    return traceEnabled;
+}
+
+qint64 Trace::now_us(){
+    return recorder().timer.nsecsElapsed() / 1000;
+}
+
+void Trace::add_span(const char *name, qint64 startUs, qint64 durationUs){
+
+    TraceRecorder &rec = recorder();
+    quintptr threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QMutexLocker lock(&rec.locker);
+    rec.events.push_back({name, startUs, durationUs, threadId});
+    if(!rec.threadsName.contains(threadId)){
+        QString threadName = QThread::currentThread()->objectName();
+        rec.threadsName[threadId] = threadName.size() > 0 ? threadName : ("thread " + QString::number(rec.threadsName.size()));
+    }
+}
+
+void Trace::write(){
+
+    if(!enabled()){
+        return;
+    }
+
+    TraceRecorder &rec = recorder();
+    QVector<TraceEvent> events;
+    QHash<quintptr, QString> threadsName;
+    {
+        QMutexLocker lock(&rec.locker);
+        std::swap(events, rec.events);
+        threadsName = rec.threadsName;
+    }
+
+    QSaveFile file(rec.filePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)){
+        qWarning() << "-Error: can't write trace file: " << rec.filePath;
+        return;
+    }
+
+    QTextStream out(&file);
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    for(auto it = threadsName.constBegin(); it != threadsName.constEnd(); ++it){
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it.key()
+            << ",\"args\":{\"name\":\"" << it.value() << "\"}}";
+        first = false;
+    }
+    for(const auto &event : events){
+        out << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+            << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    out.flush();
+
+    if(!file.commit()){
+        qWarning() << "-Error: can't write trace file: " << rec.filePath;
+        return;
+    }
+
+    qDebug() << "-Trace: " << events.size() << " spans written in " << rec.filePath;
+}
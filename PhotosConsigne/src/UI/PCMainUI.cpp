@@ -34,13 +34,19 @@
 
 
 // Qt
-#include <QCollator>
 #include <QMessageBox>
 #include <QDesktopServices>
+#include <QtConcurrent>
+#include <QElapsedTimer>
+
+// std
+#include <algorithm>
 
 // local
 #include "PCMainUI.hpp"
 #include "Work.hpp"
+#include "DebugMessage.hpp"
+#include "Trace.hpp"
 
 using namespace pc;
 
@@ -51,10 +57,27 @@ PCMainUI::PCMainUI(QApplication *parent) : m_version("4.0"), m_ui(this){
     // set icon/title
     setWindowTitle("PhotosConsigne " + m_version + " - Génération de documents PDF");
     setWindowIcon(QIcon(":/images/icon"));
+    StartupProfiler::step("ui elements");
 
     // init workers
     m_loadPhotoWorker       = std::make_unique<PhotoLoaderWorker>();
     m_pdfGeneratorWorker    = std::make_unique<PDFGeneratorWorker>();
+    m_pageThumbnailsWorker  = std::make_unique<PDFGeneratorWorker>(Counter::PageThumbnailsBusyUs);
+    m_workSaverWorker       = std::make_unique<WorkSaverWorker>(&m_resourceStore);
+    m_directoryScannerWorker = std::make_unique<DirectoryScannerWorker>();
+    StartupProfiler::step("workers");
+
+    // decoded thumbnails update the pages at most every 100 ms
+    m_thumbnailsTimer.setSingleShot(true);
+    m_thumbnailsTimer.setInterval(100);
+
+    // full photo of the photo panel
+    connect(&m_displayPhotoWatcher, &QFutureWatcher<QImage>::finished, this, [&]{
+        if(!m_displayPhotoWatcher.isCanceled()){
+            m_ui.photoW.set_image(m_displayPhotoWatcher.result());
+            m_ui.photoW.update();
+        }
+    });
 
     // connections
     from_main_UI_connections();
@@ -62,17 +85,36 @@ PCMainUI::PCMainUI(QApplication *parent) : m_version("4.0"), m_ui(this){
     from_main_module_connections();
     from_pdf_generator_worker_connections();
     from_photos_loader_worker_connections();
+    StartupProfiler::step("connections");
 
     // init threads
+    thread()->setObjectName("ui");
+    m_displayPhotoWorkerThread.setObjectName("photos loader");
+    m_pdfGeneratorWorkerThread.setObjectName("pdf generator");
+    m_pageThumbnailsWorkerThread.setObjectName("pages thumbnails");
+    m_workSaverWorkerThread.setObjectName("work saver");
+    m_directoryScannerWorkerThread.setObjectName("directory scanner");
+
     m_loadPhotoWorker->moveToThread(&m_displayPhotoWorkerThread);
     m_displayPhotoWorkerThread.start();
 
     m_pdfGeneratorWorker->moveToThread(&m_pdfGeneratorWorkerThread);
     m_pdfGeneratorWorkerThread.start();
 
+    m_pageThumbnailsWorker->moveToThread(&m_pageThumbnailsWorkerThread);
+    m_pageThumbnailsWorkerThread.start(QThread::LowestPriority);
+
+    m_workSaverWorker->moveToThread(&m_workSaverWorkerThread);
+    m_workSaverWorkerThread.start();
+
+    m_directoryScannerWorker->moveToThread(&m_directoryScannerWorkerThread);
+    m_directoryScannerWorkerThread.start();
+    StartupProfiler::step("threads");
+
     // update settings with current UI
     emit init_document_signal();
     update_settings();
+    StartupProfiler::step("document");
 }
 
 PCMainUI::~PCMainUI(){
@@ -80,11 +122,22 @@ PCMainUI::~PCMainUI(){
     emit kill_signal();
 
     // kill threads
+    m_directoryScannerWorker->cancel();
+    m_directoryScannerWorkerThread.quit();
+    m_directoryScannerWorkerThread.wait();
+
     m_displayPhotoWorkerThread.quit();
     m_displayPhotoWorkerThread.wait();
 
     m_pdfGeneratorWorkerThread.quit();
     m_pdfGeneratorWorkerThread.wait();
+
+    m_pageThumbnailsWorkerThread.quit();
+    m_pageThumbnailsWorkerThread.wait();
+
+    // a save in progress is finished before quitting
+    m_workSaverWorkerThread.quit();
+    m_workSaverWorkerThread.wait();
 }
 
 void PCMainUI::closeEvent(QCloseEvent *event){
@@ -103,13 +156,33 @@ void PCMainUI::keyPressEvent(QKeyEvent *event){
         if(m_ui.mainUI.twMiddle->currentIndex() == 0){
             m_ui.mainUI.pbRight->click();
         }
+    } else if(event->key() == Qt::Key_F12){
+        display_diagnostics_window();
     }
 }
 
+void PCMainUI::display_diagnostics_window(){
+
+    if(m_ui.diagnosticsW == nullptr){
+        m_ui.diagnosticsW = std::make_unique<DiagnosticsW>();
+    }
+
+    m_ui.diagnosticsW->show();
+    m_ui.diagnosticsW->raise();
+}
+
 void PCMainUI::add_photos_directory(){
 
     if(m_isLoadingPhotos){
+        m_directoryScannerWorker->cancel();
         emit stop_loading_photos_signal();
+
+        // the watch would send the photos not loaded yet
+        if(m_ui.mainUI.cbWatchDirectory->isChecked()){
+            QSignalBlocker blocker(m_ui.mainUI.cbWatchDirectory);
+            m_ui.mainUI.cbWatchDirectory->setChecked(false);
+            emit stop_watching_photos_directory_signal();
+        }
         return;
     }
 
@@ -124,45 +197,121 @@ void PCMainUI::add_photos_directory(){
         return;
     }
 
-    // retrieve dir
+    // ask for the sub-directories only if there are some
     QDir dir(m_settings.soft.paths.importPhotos);
-    dir.setSorting(QDir::NoSort); // will be sorted manually with std::sort
-    dir.setFilter(QDir::Files);
-    dir.setNameFilters(QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.jfif" << "*.jpe" << "*.tif" << "*.gif" << "*.bmp" << "*.pdm" << "*.ppm" << "*.xdm" << "*.xpm");
-
-    // retrieve photos name list
-    QStringList fileList = dir.entryList();
-
-    // sort the list
-    QCollator collator;
-    collator.setNumericMode(true);
-    std::sort( fileList.begin(), fileList.end(), [&collator](const QString &file1, const QString &file2){
-        return collator.compare(file1, file2) < 0;
-    });
+    bool recursive = false;
+    if(dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks).size() > 0){
+        recursive = QMessageBox::question(this, tr("Sous-répertoires"), tr("Inclure les images des sous-répertoires ?"),
+                                          QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes;
+    }
 
-    // no photo in the directory
-    if(fileList.size() == 0){
-        if(previousDirectory.size() != 0){
-            m_settings.soft.paths.importPhotos = previousDirectory; // retrieve precedent path
+    // block ui
+    m_isLoadingPhotos = true;
+    m_ui.set_ui_state_for_adding_photos(false);
+    m_ui.mainUI.laLoadingText->setText("Recherche des images...");
+
+    m_settings.soft.paths.write_new_paths();
+
+    // the photos are loaded by batches while the directory is scanned
+    m_previousDirectory = previousDirectory;
+    m_scannedDirectory = m_settings.soft.paths.importPhotos;
+    m_scannedRecursive = recursive;
+    emit scan_photos_directory_signal(m_scannedDirectory, recursive);
+
+    // the watch starts after the scan, only the photos arriving next are sent
+    if(m_ui.mainUI.cbWatchDirectory->isChecked()){
+        emit watch_photos_directory_signal(m_scannedDirectory, recursive);
+    }
+}
+
+void PCMainUI::watch_photos_directory(bool watch){
+
+    if(!watch){
+        m_ui.mainUI.laLoadingText->setText("Surveillance du dossier arrêtée.");
+        emit stop_watching_photos_directory_signal();
+        return;
+    }
+
+    // no directory added yet, the watch starts with the next one, a running loading is not canceled
+    if(m_scannedDirectory.size() == 0){
+        if(!m_isLoadingPhotos){
+            add_photos_directory();
+        }
+        if(m_scannedDirectory.size() == 0){
+            QSignalBlocker blocker(m_ui.mainUI.cbWatchDirectory);
+            m_ui.mainUI.cbWatchDirectory->setChecked(false);
+        }
+        return;
+    }
+
+    m_ui.mainUI.laLoadingText->setText("Surveillance de " + m_scannedDirectory);
+    emit watch_photos_directory_signal(m_scannedDirectory, m_scannedRecursive);
+}
+
+void PCMainUI::reload_modified_photos(QStringList photosPath){
+
+    // the files are read by the loader on copies, the photos still used by the workers are not modified
+    QSet<QString> modified = photosPath.toSet();
+    auto photos = std::make_shared<Photos>();
+    for(const auto &photo : *m_settings.photos.loaded){
+        if(!photo->isWhiteSpace && modified.contains(photo->pathPhoto)){
+            photos->push_back(std::make_shared<Photo>(*photo));
+        }
+    }
+
+    if(photos->size() > 0){
+        emit reload_photos_signal(photos);
+    }
+}
+
+void PCMainUI::replace_reloaded_photos(SPhotos photos){
+
+    QHash<quint64, SPhoto> reloaded;
+    for(const auto &photo : *photos){
+        reloaded[photo->uid] = photo;
+    }
+
+    auto replaced = std::make_shared<Photos>();
+    for(auto &&photo : *m_settings.photos.loaded){
+
+        auto it = reloaded.find(photo->uid);
+        if(it == reloaded.end()){
+            continue;
         }
 
-        QMessageBox::warning(this, tr("Avertissement"), tr("Aucune image (jpg,png) n'a pu être trouvée dans ce répertoire, veuillez en selectionner un autre.\n"),QMessageBox::Ok);
+        SPhoto reloadedPhoto = it.value();
+        reloadedPhoto->isRemoved = photo->isRemoved;
+        if(reloadedPhoto->rotation != photo->rotation){
+            reloadedPhoto->rotate((photo->rotation - reloadedPhoto->rotation + 360)%360);
+        }
+        photo = reloadedPhoto;
+        replaced->push_back(reloadedPhoto);
+    }
+
+    if(replaced->size() == 0){ // photos removed meanwhile
         return;
     }
 
-    // block ui
-    m_isLoadingPhotos = true;
-    m_ui.set_ui_state_for_adding_photos(false);
+    // the pages of the photos are drawn again once their thumbnails are decoded
+    emit decode_thumbnails_signal(replaced);
+    update_settings();
+    update_exported_pdf();
+}
+
+void PCMainUI::update_exported_pdf(){
 
-    // update photos paths
-    for(auto &&photoPath : fileList){
-        photoPath = m_settings.soft.paths.importPhotos + "/" + photoPath;
+    if(!m_ui.mainUI.cbWatchDirectory->isChecked() || !m_ui.mainUI.cbWatchExport->isChecked() || m_pcPages.pdfFileName.size() == 0){
+        return;
     }
 
-    m_settings.soft.paths.write_new_paths();
+    if(m_isGeneratingPDF){
+        m_exportAgain = true;
+        return;
+    }
 
-    // send photos path to the worker to be loaded
-    emit start_loading_photos_signal(fileList, m_settings.photos.loaded->size());
+    m_isGeneratingPDF = true;
+    m_ui.set_ui_state_for_generating_pdf(false);
+    emit start_PDF_generation_signal(m_pcPages);
 }
 
 
@@ -220,8 +369,8 @@ void PCMainUI::build_valid_sets(){
     auto nbloaded = m_settings.photos.loaded->size();
     m_settings.photos.valided->clear();
     m_settings.photos.valided->reserve(nbloaded);
-    m_ui.settingsW.setsValidedW.clear();
-    m_ui.settingsW.setsValidedW.reserve(nbloaded);
+    m_ui.settingsW.setsValided.clear();
+    m_ui.settingsW.setsValided.reserve(nbloaded);
 
     // resets id and valid set list
     for(int ii = 0; ii < nbloaded; ++ii){
@@ -234,7 +383,7 @@ void PCMainUI::build_valid_sets(){
 
         m_settings.photos.valided->push_back(m_settings.photos.loaded->at(ii));
         m_settings.photos.valided->last()->id = m_settings.photos.valided->size()-1;
-        m_ui.settingsW.setsValidedW.push_back(m_ui.settingsW.setsLoadedW.at(ii));
+        m_ui.settingsW.setsValided.push_back(m_ui.settingsW.setsLoaded.at(ii));
     }
 
     // update current PD displayed if necessary
@@ -247,14 +396,19 @@ void PCMainUI::build_valid_sets(){
 
 void PCMainUI::build_pages(){
 
+    TraceSpan span("build_pages");
+
     // update pages ui
     m_ui.settingsW.update_individual_pages(m_settings.pages.nb);
 
     // block signals
     m_ui.mainUI.twMiddle->blockSignals(true);
 
-    // reset pages
+    // the previous pages are kept and only the modified pages/sets are re-created,
+    // the ones already sent to the workers are never modified
+    QVector<SCPCPage> previousPages = std::move(m_pcPages.pages);
     m_pcPages.pages.clear();
+    ++m_pcPages.version;
     m_pcPages.pages.reserve(m_settings.pages.nb);
 
     // set all photos not in the document
@@ -266,72 +420,91 @@ void PCMainUI::build_pages(){
     // general pages parameters
     m_pcPages.settings = m_settings.document;
 
-    // create new pages
+    // shared global settings, kept while their values don't change
+    m_sharedSetsSettings    = share_settings(m_sharedSetsSettings, m_settings.sets);
+    m_sharedPagesSettings   = share_settings(m_sharedPagesSettings, m_settings.pages);
+    m_sharedHeaderSettings  = share_settings(m_sharedHeaderSettings, m_settings.header);
+    m_sharedFooterSettings  = share_settings(m_sharedFooterSettings, m_settings.footer);
+
+    // update pages
     int currentId = 0;
     for(int ii = 0; ii < m_settings.pages.nb; ++ii){
 
-        // build page
-        SPCPage pcPage = std::make_shared<PCPage>(PCPage());
+        SCPCPage previousPage = (ii < previousPages.size()) ? previousPages[ii] : nullptr;
 
         // define current nb of photos for this page
         auto pageUI = m_ui.settingsW.pagesW[ii].get();
 
         // only global
         // # misc
-        pcPage->id                      = ii;
-        pcPage->drawThisPage            = m_settings.document.saveOnlyCurrentPage ? (ii == m_settings.pages.currentId) : true;
-
-        // # header
-        pcPage->header->settings        = m_settings.header;
-
-        // # footer
-        pcPage->footer->settings        = m_settings.footer;
+        bool drawThisPage = m_settings.document.saveOnlyCurrentPage ? (ii == m_settings.pages.currentId) : true;
 
         // global or individual
         bool individualPageSettings = pageUI->individual();
 
         // # background
+        SPageSettings pageSettings = m_sharedPagesSettings;
         if(individualPageSettings){
-            pageUI->update_settings(pcPage->settings);
-        }else{
-            pcPage->settings = m_settings.pages;
+            PageSettings individualSettings;
+            pageUI->update_settings(individualSettings);
+            pageSettings = share_settings((previousPage != nullptr) ? previousPage->settings : nullptr, individualSettings);
         }
 
         // sets
-        int nbSets = pcPage->settings.positions.customMode ? pcPage->settings.positions.relativePosCustom.size() : pcPage->settings.positions.nbPhotos;
+        int nbSets = pageSettings->positions.customMode ? pageSettings->positions.relativePosCustom.size() : pageSettings->positions.nbPhotos;
 
-        pcPage->sets.reserve(nbSets);
+        QVector<SPCSet> sets;
+        sets.reserve(nbSets);
         for(int jj = 0; jj < nbSets; ++jj){
 
-            // build set
-            SPCSet set = std::make_shared<PCSet>(PCSet());
+            if(currentId >= m_settings.photos.valided->size()){
+                break;
+            }
 
-            // only global
-            set->id      = jj;
-            set->totalId = currentId;
+            SPhoto photo = m_settings.photos.valided->at(currentId);
+            photo->isOnDocument = true; // photo will be on the generated document
+            photo->pageId = ii;
 
-            if(currentId < m_settings.photos.valided->size()){
+            // set at the same place in the previous page
+            SPCSet set = (previousPage != nullptr && jj < previousPage->sets.size()) ? previousPage->sets[jj] : nullptr;
 
-                auto setW = m_ui.settingsW.setsValidedW[currentId].get();
-                if(setW->ui.cbEnableIndividualConsign->isChecked()){
-                    setW->update_settings(set->settings);
-                }else{
-                    set->settings       = m_settings.sets;
-                }
+            const auto &setData = m_ui.settingsW.setsValided[currentId];
+            SSetSettings setSettings = setData->enabled ? setData->settings : m_sharedSetsSettings;
 
-                set->photo = m_settings.photos.valided->at(currentId);
-                set->photo->isOnDocument = true; // photo will be on the generated document
-                set->photo->pageId = ii;                
-                set->text = std::make_shared<Consign>(Consign());                
+            // reuse it if nothing changed
+            if(set == nullptr || set->totalId != currentId || set->source != photo || set->photo->version != photo->version || set->settings != setSettings){
 
-            }else{
-                break;
-            }                       
+                // build set
+                set = std::make_shared<PCSet>(PCSet());
+                set->id         = jj;
+                set->totalId    = currentId;
+                set->settings   = setSettings;
+                set->photo      = photo->snapshot();
+                set->source     = photo;
+                set->text       = std::make_shared<Consign>(Consign());
+            }
 
-            pcPage->sets.push_back(set);
+            sets.push_back(set);
             currentId++;
         }
 
+        // reuse the previous page if nothing changed
+        if(previousPage != nullptr && previousPage->drawThisPage == drawThisPage && previousPage->sets == sets &&
+           previousPage->settings == pageSettings &&
+           previousPage->header->settings == m_sharedHeaderSettings && previousPage->footer->settings == m_sharedFooterSettings){
+            m_pcPages.pages.push_back(previousPage);
+            continue;
+        }
+
+        // build page
+        SPCPage pcPage = std::make_shared<PCPage>(PCPage());
+        pcPage->id                  = ii;
+        pcPage->drawThisPage        = drawThisPage;
+        pcPage->settings            = pageSettings;
+        pcPage->header->settings    = m_sharedHeaderSettings;
+        pcPage->footer->settings    = m_sharedFooterSettings;
+        pcPage->sets                = std::move(sets);
+
         // add page to pages list widget and update the ui
         m_pcPages.pages.push_back(pcPage);
     }
@@ -345,13 +518,131 @@ void PCMainUI::build_pages(){
     m_ui.mainUI.twMiddle->blockSignals(false);
 }
 
+void PCMainUI::add_work_resource(QUrl url, QImage image){
+
+    m_ui.add_resource_from_xml(url, image);
+    if(url.toString().left(14) == "dropped_image_"){
+        TextEdit::currentDroppedImage++;
+    }
+    emit m_ui.resource_added_signal(std::move(url), std::move(image));
+}
+
+void PCMainUI::save_work(const QString &filePath){
+
+    // only the snapshot is taken on the UI thread, the saver worker serializes and writes it
+    WorkSnapshot snapshot;
+    snapshot.filePath = filePath;
+    snapshot.binary   = filePath.endsWith(".pcwork");
+
+    snapshot.photos.reserve(m_settings.photos.loaded->size());
+    for(const auto &photo : *m_settings.photos.loaded){
+        snapshot.photos.push_back(std::make_shared<Photo>(*photo));
+    }
 
+    snapshot.resourcesUrl    = m_pdfGeneratorWorker->droppedUrl + m_pdfGeneratorWorker->insertedUrl;
+    snapshot.resourcesImages = m_pdfGeneratorWorker->droppedImages + m_pdfGeneratorWorker->insertedImages;
+
+    // the binary container keeps only the individual sets overriding the global one
+    QXmlStreamWriter xml(&snapshot.settings);
+    m_ui.write_to_xml(xml, snapshot.binary);
+
+    emit m_ui.set_progress_bar_text_signal("Sauvegarde de " + filePath);
+    emit start_saving_work_signal(std::move(snapshot));
+}
+
+void PCMainUI::load_work_archive(const QString &filePath){
+
+    emit m_ui.set_progress_bar_text_signal("Chargement de " + filePath);
+    emit m_ui.set_progress_bar_state_signal(0);
+
+    WorkArchiveContent content;
+    if(!WorkArchive::load(filePath, content)){
+        QMessageBox::warning(this, tr("Avertissement"), tr("Le document de travail n'a pu être chargé.\n"),QMessageBox::Ok);
+        return;
+    }
+
+    m_settings.photos.loaded->clear();
+    m_ui.settingsW.reset_individual_sets(0);
+
+    // # resources
+    for(int ii = 0; ii < content.resourcesUrl.size(); ++ii){
+        m_resourceStore.register_content(content.resourcesImages[ii], content.resourcesKey[ii], content.resourcesData[ii]);
+        add_work_resource(content.resourcesUrl[ii], content.resourcesImages[ii]);
+    }
+
+    // # photos, no photo file is accessed
+    for(const auto &photo : *content.photos){
+        m_settings.photos.loaded->push_back(photo);
+        m_ui.settingsW.insert_individual_set(m_settings.photos.loaded->size()-1);
+    }
+    m_settings.photos.currentId = std::max(0, m_settings.photos.loaded->size()-1);
+    emit m_ui.set_progress_bar_state_signal(500);
+
+    // # settings
+    QXmlStreamReader xml(content.settings);
+    while(!xml.atEnd() && !xml.hasError()) {
+        if(xml.readNext() == QXmlStreamReader::StartElement && xml.name() == "Document"){
+            m_ui.load_from_xml(xml,true);
+            update_settings_with_no_preview();
+            m_ui.load_from_xml(xml,false);
+        }
+    }
+
+    // the placeholders from the archive are displayed until the full thumbnails are decoded
+    emit decode_thumbnails_signal(std::make_shared<Photos>(*m_settings.photos.loaded));
+    update_settings();
+}
+
+void PCMainUI::end_loading_work(SPhotos photos){
+
+    for(const auto &photo : *photos){
+        m_settings.photos.loaded->push_back(photo);
+        m_ui.settingsW.insert_individual_set(m_settings.photos.loaded->size()-1);
+    }
+    m_settings.photos.currentId = std::max(0, m_settings.photos.loaded->size()-1);
+    emit m_ui.set_progress_bar_state_signal(500);
+
+    // # settings
+    QFile file(m_workFilePath);
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text)){
+        QXmlStreamReader xml;
+        xml.setDevice(&file);
+        while(!xml.atEnd() && !xml.hasError()) {
+            if(xml.readNext() == QXmlStreamReader::StartElement && xml.name() == "Document"){
+                m_ui.load_from_xml(xml,true);
+                update_settings_with_no_preview();
+                m_ui.load_from_xml(xml,false);
+            }
+        }
+    }else{
+        qWarning() << "-Error: work file " << m_workFilePath << " can't be reopened.";
+    }
+
+    // the preview page photos are moved at the front of the queue by update_settings
+    emit decode_thumbnails_signal(std::make_shared<Photos>(*m_settings.photos.loaded));
+    update_settings();
+
+    m_ui.set_ui_state_for_loading_work(true);
+    emit m_ui.set_progress_bar_text_signal(m_workFilePath + " chargé.");
+    emit m_ui.set_progress_bar_state_signal(1000);
+}
 
 void PCMainUI::update_photo_to_display(SPhoto photo)
 {
     if(!photo->isWhiteSpace){
-        m_ui.photoW.set_image(QImage(photo->pathPhoto).transformed(QTransform().rotate(photo->rotation)));
+
+        // display the thumbnail at once (can be the embedded EXIF one), the full photo is read in background
+        if(!photo->scaledPhoto.isNull()){
+            m_ui.photoW.set_image(photo->scaledPhoto);
+        }
+
+        QString path = photo->pathPhoto;
+        int rotation = photo->rotation;
+        m_displayPhotoWatcher.setFuture(QtConcurrent::run([path, rotation]{
+            return QImage(path).transformed(QTransform().rotate(rotation));
+        }));
     }else{
+        m_displayPhotoWatcher.cancel();
 
         QImage whiteImg(100, 100, QImage::Format_RGB32);
         whiteImg.fill(Qt::white);
@@ -429,7 +720,7 @@ void PCMainUI::define_selected_page_from_current_photo(){
 
         for(const auto &set : page->sets){
 
-            if(set->photo->loadedId == m_settings.photos.loaded->at(m_settings.photos.currentId)->loadedId){
+            if(set->source->loadedId == m_settings.photos.loaded->at(m_settings.photos.currentId)->loadedId){
                 idPage = page->id;
                 break;
             }
@@ -452,20 +743,7 @@ void PCMainUI::from_main_UI_connections()
     // # timer
     connect(&m_ui.zonesTimer, &QTimer::timeout, this, [=]{
         m_ui.zonesTimer.stop();
-
-        // check if the preview is already computing and will ask later to a new update if it's the case
-        m_previewLocker.lockForWrite();
-        bool isPreviewComputing = m_isPreviewComputing;
-        m_generatePreviewAgain = isPreviewComputing;
-        m_previewLocker.unlock();
-
-        // ask for a preview generation
-        if(!isPreviewComputing){
-            m_previewLocker.lockForWrite();
-            m_isPreviewComputing = true;
-            m_previewLocker.unlock();
-            emit start_preview_generation_signal(m_pcPages, m_settings.pages.currentId, false);
-        }
+        ask_for_preview_generation(false);
     });
 
     // main ui
@@ -477,83 +755,20 @@ void PCMainUI::from_main_UI_connections()
 
     connect(m_ui.mainUI.pbSaveWork, &QPushButton::clicked, this, [&]{ // save work
 
-        QString filePath = QFileDialog::getSaveFileName(this, "Entrez le nom du document de travail", m_settings.soft.paths.works, "Work (*.work)");
+        QString filePath = QFileDialog::getSaveFileName(this, "Entrez le nom du document de travail", m_settings.soft.paths.works, "Work (*.work);;Work binaire (*.pcwork)");
         if(filePath.size() > 0){
-
-            QFile file(filePath);
-            if(!file.open(QIODevice::WriteOnly | QIODevice::Text)){
-                return;
-            }
-
-            QString dirResourcesPath = filePath;
-            dirResourcesPath.resize(dirResourcesPath.size()-5);
-            dirResourcesPath += "_resources";
-
-            QDir dirResources(dirResourcesPath);
-            if(!dirResources.exists()){
-                dirResources.mkdir(".");
-            }
-
-            QXmlStreamWriter xml;
-            xml.setDevice(&file);
-            xml.setAutoFormatting(true);
-
-            xml.writeStartElement("Work");
-            xml.writeStartElement("Resources");
-                xml.writeAttribute("nbImages", QString::number(m_pdfGeneratorWorker->droppedUrl.size()+m_pdfGeneratorWorker->insertedUrl.size()));
-
-                    for(int ii = 0; ii < m_pdfGeneratorWorker->droppedUrl.size(); ++ii){
-
-                        QString path = dirResourcesPath + "/" + m_pdfGeneratorWorker->droppedUrl[ii].toString() + ".png";
-                        if(m_pdfGeneratorWorker->droppedImages[ii].save(path)){
-                            xml.writeStartElement("ImageAdded");
-                            xml.writeAttribute("url", m_pdfGeneratorWorker->droppedUrl[ii].toString());
-                            xml.writeAttribute("path", path);
-                            xml.writeEndElement();
-                        }
-                    }
-
-                    for(int ii = 0; ii < m_pdfGeneratorWorker->insertedUrl.size(); ++ii){
-
-                        QString path = dirResourcesPath + "/inserted_image_" + QString::number(ii) + ".png";
-                        if(m_pdfGeneratorWorker->insertedImages[ii].save(path)){
-                            xml.writeStartElement("ImageAdded");
-                            xml.writeAttribute("url", m_pdfGeneratorWorker->insertedUrl[ii].toString());
-                            xml.writeAttribute("path", path);
-                            xml.writeEndElement();
-                        }
-                    }
-
-            xml.writeEndElement();
-            xml.writeStartElement("Photos");
-                xml.writeAttribute("number", QString::number(m_settings.photos.loaded->size()));
-                for(const auto &photo : *m_settings.photos.loaded){
-                    xml.writeStartElement("Photo");
-                    xml.writeAttribute("path", photo->pathPhoto);
-                    xml.writeAttribute("id", QString::number(photo->id));
-                    xml.writeAttribute("pageId", QString::number(photo->pageId));
-                    xml.writeAttribute("loadedId", QString::number(photo->loadedId));
-                    xml.writeAttribute("rotation", QString::number(photo->rotation));
-                    xml.writeAttribute("white", QString::number(photo->isWhiteSpace));
-                    xml.writeAttribute("duplicate", QString::number(photo->isADuplicate));
-                    xml.writeAttribute("onDoc", QString::number(photo->isOnDocument));
-                    xml.writeAttribute("removed", QString::number(photo->isRemoved));
-                    xml.writeEndElement();
-                }
-            xml.writeEndElement();
-            m_ui.write_to_xml(xml);
-            xml.writeEndElement();
-            xml.writeEndDocument();
+            save_work(filePath);
         }
-
     });
     connect(m_ui.mainUI.pbLoadWork, &QPushButton::clicked, this, [&]{ // load work
 
         m_ui.set_ui_state_for_loading_work(false);
 
-        QString filePath = QFileDialog::getOpenFileName(this, "Choisissez un document de travail à charger", m_settings.soft.paths.works, "Work (*.work)");
+        QString filePath = QFileDialog::getOpenFileName(this, "Choisissez un document de travail à charger", m_settings.soft.paths.works, "Work (*.work *.pcwork)");
 
-        if(filePath.size() > 0){
+        if(filePath.size() > 0 && WorkArchive::is_archive(filePath)){
+            load_work_archive(filePath);
+        }else if(filePath.size() > 0){
 
             QFile file(filePath);
             if(!file.open(QIODevice::ReadOnly | QIODevice::Text)){
@@ -569,10 +784,8 @@ void PCMainUI::from_main_UI_connections()
             m_settings.photos.loaded->clear();
             m_ui.settingsW.reset_individual_sets(0);
 
-
-
-            // update current photo row
-            int nbPhotos = 1;
+            // the resources and the photos elements are read first, the document settings once the photos are loaded
+            QVector<QXmlStreamAttributes> photosAttributes;
             QXmlStreamReader::TokenType token;
             while(!xml.atEnd() && !xml.hasError()) {
 
@@ -587,46 +800,21 @@ void PCMainUI::from_main_UI_connections()
                         QImage img(xml.attributes().value("path").toString());
                         QUrl url(xml.attributes().value("url").toString());
                         if(!img.isNull()){
-
-                            m_ui.add_resource_from_xml(url, img);
-
-                            emit m_ui.resource_added_signal(url,std::move(img));
-                            if(xml.attributes().value("url").toString().left(14) == "dropped_image_"){
-                                TextEdit::currentDroppedImage++;
-                            }
+                            m_resourceStore.register_resource(img, xml.attributes().value("path").toString());
+                            add_work_resource(url, std::move(img));
                         }
                     }
-                    else if(xml.name() == "Photos"){
-
-                        nbPhotos = xml.attributes().value("number").toInt();
-                        m_settings.photos.loaded->reserve(nbPhotos);
-
-                    }else if(xml.name() == "Photo"){
-
-                        SPhoto photo = std::make_shared<Photo>(xml.attributes().value("path").toString(), xml.attributes().value("white").toInt());
-                        photo->id           = xml.attributes().value("id").toInt();
-                        photo->pageId       = xml.attributes().value("pageId").toInt();
-                        photo->loadedId     = xml.attributes().value("loadedId").toInt();
-                        photo->rotation     = xml.attributes().value("rotation").toInt();
-                        photo->scaledPhoto  = photo->scaledPhoto.transformed(QTransform().rotate(photo->rotation));
-                        photo->isADuplicate = xml.attributes().value("duplicate").toInt();
-                        photo->isOnDocument = xml.attributes().value("onDoc").toInt();
-                        photo->isRemoved    = xml.attributes().value("removed").toInt();
-                        m_settings.photos.loaded->push_back(photo);
-                        emit m_ui.set_progress_bar_state_signal(static_cast<int>(1000.*m_settings.photos.loaded->size()/nbPhotos));
-
-                        m_ui.settingsW.insert_individual_set(m_settings.photos.loaded->size()-1);
-                        m_settings.photos.currentId = m_settings.photos.loaded->size()-1;
-                    }else if(xml.name() == "Document"){
-
-                        m_ui.load_from_xml(xml,true);
-                        update_settings_with_no_preview();
-                        m_ui.load_from_xml(xml,false);
+                    else if(xml.name() == "Photo"){
+                        photosAttributes.push_back(xml.attributes());
                     }
                 }
             }
 
-            update_settings();
+            // the headers of the photos are read by the loader, the loading ends in end_loading_work
+            m_workFilePath = filePath;
+            emit m_ui.set_progress_bar_text_signal("Lecture des en-têtes des photos...");
+            emit load_work_photos_signal(photosAttributes);
+            return;
         }
         m_ui.set_ui_state_for_loading_work(true);
         emit m_ui.set_progress_bar_text_signal(filePath + " chargé.");
@@ -648,6 +836,7 @@ void PCMainUI::from_main_UI_connections()
     });
     // ## add photos directory
     connect(m_ui.mainUI.pbAddPhotosDIrectory, &QPushButton::clicked, this, &PCMainUI::add_photos_directory);
+    connect(m_ui.mainUI.cbWatchDirectory, &QCheckBox::toggled, this, &PCMainUI::watch_photos_directory);
     // ## save PDF
     connect(m_ui.mainUI.pbSavePDF, &QPushButton::clicked, this, [&]{
 
@@ -660,6 +849,7 @@ void PCMainUI::from_main_UI_connections()
             m_settings.soft.paths.write_new_paths();
 
             m_pcPages.pdfFileName = filePath;
+            m_isGeneratingPDF = true;
             m_ui.set_ui_state_for_generating_pdf(false);
             emit start_PDF_generation_signal(m_pcPages);
         }
@@ -709,8 +899,7 @@ void PCMainUI::from_main_UI_connections()
         }
 
         SPhoto photo       = m_settings.photos.loaded.get()->at(m_settings.photos.currentId);
-        photo->rotation    =(photo->rotation - 90)%360;
-        photo->scaledPhoto = photo->scaledPhoto.transformed(QTransform().rotate(-90));
+        photo->rotate(-90);
         update_photo_to_display(photo);
         update_settings();
     });
@@ -722,8 +911,7 @@ void PCMainUI::from_main_UI_connections()
         }
 
         SPhoto photo        = m_settings.photos.loaded.get()->at(m_settings.photos.currentId);
-        photo->rotation     = (photo->rotation + 90)%360;
-        photo->scaledPhoto  = photo->scaledPhoto.transformed(QTransform().rotate(90));
+        photo->rotate(90);
         update_photo_to_display(photo);
         update_settings();
     });
@@ -792,6 +980,10 @@ void PCMainUI::from_main_UI_connections()
         SPhoto duplicatedPhoto = std::make_shared<Photo>(Photo(*(m_settings.photos.loaded.get()->at(m_settings.photos.currentId))));
         duplicatedPhoto->isRemoved    = false;
         duplicatedPhoto->isADuplicate = true;
+        duplicatedPhoto->uid          = Photo::new_uid();
+        if(!duplicatedPhoto->isLoaded){ // the copy is not in the decoding queue
+            duplicatedPhoto->set_thumbnail(Photo::read_thumbnail(duplicatedPhoto->pathPhoto));
+        }
 
         // insert it
         m_settings.photos.loaded->insert(m_settings.photos.currentId+1, duplicatedPhoto);
@@ -820,7 +1012,7 @@ void PCMainUI::from_main_UI_connections()
         }
 
         m_settings.photos.loaded->swap(row,index);
-        m_ui.settingsW.setsLoadedW.insert(index, m_ui.settingsW.setsLoadedW.takeAt(row));
+        m_ui.settingsW.setsLoaded.insert(index, m_ui.settingsW.setsLoaded.takeAt(row));
 
         select_photo(index, m_ui.mainUI.twMiddle->currentIndex() == 0);
         update_settings();
@@ -837,12 +1029,14 @@ void PCMainUI::from_main_UI_connections()
      });
     // # list widget
     // ## photos list
-    connect(m_ui.mainUI.lwPhotosList, &QListWidget::clicked, this, [&](QModelIndex index){
+    connect(m_ui.mainUI.lvPhotosList, &QListView::clicked, this, [&](QModelIndex index){
         select_photo(index.row());
     });
-    connect(m_ui.mainUI.lwPhotosList, &QListWidget::currentRowChanged, this, [&](int row){
+    connect(m_ui.mainUI.lvPhotosList->selectionModel(), &QItemSelectionModel::currentRowChanged, this, [&](const QModelIndex &current){
 
-        select_photo(row);
+        if(current.isValid()){
+            select_photo(current.row());
+        }
     });
     // ## pages list
     connect(m_ui.mainUI.lwPagesList, &QListWidget::currentRowChanged, this, [&](int row){
@@ -883,16 +1077,42 @@ void PCMainUI::from_main_UI_connections()
 void PCMainUI::from_main_module_connections(){
 
     // to pdf generator worker
-    connect(this, &PCMainUI::kill_signal,                       m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::kill);
+    connect(this, &PCMainUI::kill_signal,                       m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::kill, Qt::DirectConnection);
     connect(this, &PCMainUI::start_preview_generation_signal,   m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::generate_preview);
     connect(this, &PCMainUI::start_PDF_generation_signal,       m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::generate_PDF);
     connect(this, &PCMainUI::init_document_signal,              m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::init_document);
 
+    // to pages thumbnails worker
+    connect(this, &PCMainUI::kill_signal,                               m_pageThumbnailsWorker.get(), &PDFGeneratorWorker::kill);
+    connect(this, &PCMainUI::init_document_signal,                      m_pageThumbnailsWorker.get(), &PDFGeneratorWorker::init_document);
+    connect(this, &PCMainUI::start_pages_thumbnails_generation_signal,  m_pageThumbnailsWorker.get(), &PDFGeneratorWorker::generate_pages_thumbnails);
+
     // to photo display worker
     connect(this, &PCMainUI::kill_signal,            m_loadPhotoWorker.get(), &PhotoLoaderWorker::kill);
     connect(this, &PCMainUI::start_loading_photos_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::load_photos_directory);
     connect(this, &PCMainUI::stop_loading_photos_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::kill);
-
+    connect(this, &PCMainUI::scan_photos_directory_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::start_appending_photos);
+    connect(this, &PCMainUI::scan_photos_directory_signal, m_directoryScannerWorker.get(), &DirectoryScannerWorker::scan_directory);
+    // scanned batches go straight to the loader, they are read in the order they are found
+    connect(m_directoryScannerWorker.get(), &DirectoryScannerWorker::photos_found_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::append_photos);
+    connect(m_directoryScannerWorker.get(), &DirectoryScannerWorker::end_scanning_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::end_appending_photos);
+    connect(this, &PCMainUI::watch_photos_directory_signal, m_directoryScannerWorker.get(), &DirectoryScannerWorker::watch_directory);
+    connect(this, &PCMainUI::stop_watching_photos_directory_signal, m_directoryScannerWorker.get(), &DirectoryScannerWorker::stop_watching);
+    connect(m_directoryScannerWorker.get(), &DirectoryScannerWorker::photos_modified_signal, this, &PCMainUI::reload_modified_photos);
+    connect(this, &PCMainUI::decode_thumbnails_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::decode_thumbnails);
+    connect(this, &PCMainUI::reload_photos_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::reload_photos);
+    connect(this, &PCMainUI::prioritize_photos_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::prioritize_photos);
+    connect(this, &PCMainUI::load_work_photos_signal, m_loadPhotoWorker.get(), &PhotoLoaderWorker::load_work_photos);
+
+    // to work saver worker
+    connect(this, &PCMainUI::start_saving_work_signal, m_workSaverWorker.get(), &WorkSaverWorker::save_work);
+    connect(m_workSaverWorker.get(), &WorkSaverWorker::work_saved_signal, this, [&](QString filePath, bool success){
+        if(success){
+            emit m_ui.set_progress_bar_text_signal(filePath + " sauvegardé.");
+        }else{
+            QMessageBox::warning(this, tr("Avertissement"), tr("Le document de travail n'a pu être sauvegardé.\n"),QMessageBox::Ok);
+        }
+    });
 }
 
 
@@ -900,14 +1120,24 @@ void PCMainUI::from_pdf_generator_worker_connections(){
 
     PDFGeneratorWorker *worker = m_pdfGeneratorWorker.get();
 
+    // to preview
+    connect(worker, &PDFGeneratorWorker::end_preview_tile_signal, &m_ui.previewW, &PreviewW::set_tile);
+
     // to this
     connect(worker, &PDFGeneratorWorker::end_preview_signal, this, [=](QImage previewImage, SPCPage previewPage){
 
+        QElapsedTimer timer;
+        timer.start();
+
         m_ui.previewW.set_image(std::move(previewImage));
         m_ui.previewW.set_page(previewPage);
+        m_ui.previewW.set_max_page_size(PDFGeneratorWorker::preview_size(m_pcPages.settings.paperFormat, PDFGeneratorWorker::maxPreviewDPI).toSize());
         m_ui.previewW.set_current_pc(m_settings.sets.currentId);
         m_ui.previewW.update();
 
+        Counters::set(Counter::PreviewDisplayUs, timer.nsecsElapsed()/1000);
+        Counters::set(Counter::PreviewLatencyUs, m_previewTimer.nsecsElapsed()/1000);
+
         m_ui.mainUI.pbSavePDF->setEnabled(true);
 
         m_previewLocker.lockForWrite();
@@ -930,14 +1160,24 @@ void PCMainUI::from_pdf_generator_worker_connections(){
             m_ui.mainUI.laLoadingText->setText("Echec génération du PDF");
         }
 
+        m_isGeneratingPDF = false;
         m_ui.set_ui_state_for_generating_pdf(true);
+
+        // photos added during the export
+        if(m_exportAgain){
+            m_exportAgain = false;
+            update_exported_pdf();
+        }
     });
     connect(worker, &PDFGeneratorWorker::set_progress_bar_state_signal, m_ui.mainUI.progressBarLoading, &QProgressBar::setValue);
     connect(worker, &PDFGeneratorWorker::set_progress_bar_text_signal,  m_ui.mainUI.laLoadingText, &QLabel::setText);
+    connect(m_pageThumbnailsWorker.get(), &PDFGeneratorWorker::end_page_thumbnail_signal, &m_ui, &UIElements::set_page_thumbnail);
     connect(worker, &PDFGeneratorWorker::abort_pdf_signal,              this, [=](QString pathFile){
 
         QMessageBox::warning(this, tr("Avertissement"), tr("Le fichier PDF ") + pathFile + tr(" n'a pu être écrit, il se peut que celui-ci soit en cours d'utilisation par un autre logiciel."),QMessageBox::Ok);
         m_ui.mainUI.laLoadingText->setText("Echec génération du PDF");
+        m_isGeneratingPDF = false;
+        m_exportAgain     = false;
         m_ui.set_ui_state_for_generating_pdf(true);
     });
 }
@@ -952,6 +1192,11 @@ void PCMainUI::from_photos_loader_worker_connections(){
     // # end loading photo
     connect(worker, &PhotoLoaderWorker::photo_loaded_signal,this, [&](SPhoto photo, int indexToInsert){
 
+        // photos found by a directory scan are appended
+        if(indexToInsert < 0){
+            indexToInsert = m_settings.photos.loaded->size();
+        }
+
         // add loaded photo
         m_settings.photos.loaded->insert(indexToInsert, photo);
         m_ui.settingsW.insert_individual_set(indexToInsert);
@@ -961,6 +1206,18 @@ void PCMainUI::from_photos_loader_worker_connections(){
 
         update_settings();
     });
+    // # end scanning directory
+    connect(m_directoryScannerWorker.get(), &DirectoryScannerWorker::end_scanning_signal, this, [&](int nbPhotosFound, bool canceled){
+        if(nbPhotosFound == 0 && !canceled){
+
+            // retrieve precedent path
+            if(m_previousDirectory.size() != 0){
+                m_settings.soft.paths.importPhotos = m_previousDirectory;
+                m_settings.soft.paths.write_new_paths();
+            }
+            QMessageBox::warning(this, tr("Avertissement"), tr("Aucune image n'a pu être trouvée dans ce répertoire, veuillez en selectionner un autre.\n"),QMessageBox::Ok);
+        }
+    });
     // # end loading all photos
     connect(worker, &PhotoLoaderWorker::end_loading_photos_signal,this, [&]{
 
@@ -973,7 +1230,34 @@ void PCMainUI::from_photos_loader_worker_connections(){
         m_ui.set_ui_state_for_adding_photos(true);
 
         select_photo(m_settings.photos.currentId, m_ui.mainUI.twMiddle->currentIndex() == 0);
-        update_settings();        
+        update_settings();
+        update_exported_pdf();
+    });
+    // # headers of the work photos read
+    connect(worker, &PhotoLoaderWorker::work_photos_loaded_signal, this, &PCMainUI::end_loading_work);
+    // # modified photos of the watched directory read again
+    connect(worker, &PhotoLoaderWorker::photos_reloaded_signal, this, &PCMainUI::replace_reloaded_photos);
+    // # thumbnail decoded in background
+    connect(worker, &PhotoLoaderWorker::thumbnail_loaded_signal,this, [&](SPhoto photo, QImage thumbnail){
+
+        photo->set_thumbnail(std::move(thumbnail));
+
+        // the pages are rebuilt once for the thumbnails decoded in a row, only the sets of the photos are re-created
+        if(photo->isOnDocument){
+            m_previewThumbnailDecoded |= photo->pageId == m_settings.pages.currentId;
+            if(!m_thumbnailsTimer.isActive()){
+                m_thumbnailsTimer.start();
+            }
+        }
+    });
+    connect(&m_thumbnailsTimer, &QTimer::timeout, this, [&]{
+
+        build_pages();
+        if(m_previewThumbnailDecoded){
+            m_previewThumbnailDecoded = false;
+            ask_for_preview_generation(false);
+        }
+        request_pages_thumbnails();
     });
 }
 
@@ -982,11 +1266,22 @@ void PCMainUI::from_UI_elements_connections(){
     PreviewW &previewW    = m_ui.previewW;
     PhotoW &displayPhotoW = m_ui.photoW;
 
+    // # diagnostics
+    connect(&m_ui, &UIElements::diagnostics_window_asked_signal, this, &PCMainUI::display_diagnostics_window);
+
     // # UI elements
     // ### resource added
     connect(&m_ui, &UIElements::resource_added_signal, m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::add_resource);
+    connect(&m_ui, &UIElements::resource_added_signal, m_pageThumbnailsWorker.get(), &PDFGeneratorWorker::add_resource);
 
     // # preview label
+    // ### zoom
+    connect(&previewW, &PreviewW::tiles_requested_signal, m_pdfGeneratorWorker.get(), &PDFGeneratorWorker::generate_preview_tiles);
+    connect(&previewW, &PreviewW::larger_preview_needed_signal, this, [&]{
+        if(!m_settings.document.noPreviewGeneration){
+            ask_for_preview_generation(false);
+        }
+    });
     // ### double click
     connect(&previewW, &PreviewW::double_click_on_photo_signal, this, [&]{
         if(m_settings.sets.currentId < m_settings.photos.valided->size()){
@@ -1021,6 +1316,9 @@ void PCMainUI::from_UI_elements_connections(){
 
 void PCMainUI::update_settings(){
 
+    QElapsedTimer timer;
+    timer.start();
+
     // update global settings
     m_ui.update_global_settings(m_settings);
 
@@ -1032,15 +1330,31 @@ void PCMainUI::update_settings(){
 
     m_ui.update_photos_list(m_settings);
     m_ui.update_pages_list(m_pcPages);
+    request_pages_thumbnails();
 
     // update ui
     m_ui.update_UI(m_settings);
 
 
-    if(m_ui.settingsW.setsValidedW.size() >0){
-        m_settings.sets.currentIdDisplayed = m_ui.settingsW.setsValidedW[m_settings.sets.currentId]->id;
+    if(m_ui.settingsW.setsValided.size() >0){
+        m_settings.sets.currentIdDisplayed = m_ui.settingsW.setsValided[m_settings.sets.currentId]->id;
     }
 
+    // decode first the thumbnails of the photos which will be displayed
+    prioritize_thumbnails_decoding();
+    Counters::set(Counter::PreviewPagesUs, timer.nsecsElapsed()/1000);
+
+    if(!m_settings.document.noPreviewGeneration){
+        ask_for_preview_generation(m_ui.zonesTimer.isActive());
+    }else{
+        m_previewLocker.lockForWrite();
+        m_generatePreviewAgain = m_isPreviewComputing;
+        m_previewLocker.unlock();
+    }
+}
+
+void PCMainUI::ask_for_preview_generation(bool drawZones){
+
     // check if the preview is already computing and will ask later to a new update if it's the case
     m_previewLocker.lockForWrite();
     bool isPreviewComputing = m_isPreviewComputing;
@@ -1048,13 +1362,59 @@ void PCMainUI::update_settings(){
     m_previewLocker.unlock();
 
     // ask for a preview generation
-    if(!m_settings.document.noPreviewGeneration && !isPreviewComputing){
+    if(!isPreviewComputing){
         m_previewLocker.lockForWrite();
         m_isPreviewComputing = true;
         m_previewLocker.unlock();
-        emit start_preview_generation_signal(m_pcPages, m_settings.pages.currentId, m_ui.zonesTimer.isActive());
+        m_previewTimer.start();
+
+        // rendered at the displayed size, the hidden widget has no meaningful size yet
+        QSize targetSize;
+        if(m_ui.previewW.isVisible()){
+            targetSize = (QSizeF(m_ui.previewW.size())*m_ui.previewW.devicePixelRatioF()).toSize();
+        }
+        emit start_preview_generation_signal(m_pcPages, m_settings.pages.currentId, drawZones, targetSize);
     }
 }
 
+void PCMainUI::request_pages_thumbnails(){
+
+    QVector<int> pagesId;
+    QVector<uint> pagesHash;
+    m_ui.update_pages_thumbnails(m_pcPages, m_settings.pages.currentId, pagesId, pagesHash);
+
+    // always sent, even empty, to cancel the outdated requests
+    emit start_pages_thumbnails_generation_signal(m_pcPages, pagesId, pagesHash);
+}
+
+void PCMainUI::prioritize_thumbnails_decoding(){
 
+    SPhotos photos = std::make_shared<Photos>();
 
+    // # current selected photo
+    if(m_settings.photos.currentId < m_settings.photos.loaded->size()){
+        SPhoto currentPhoto = m_settings.photos.loaded->at(m_settings.photos.currentId);
+        if(!currentPhoto->isLoaded){
+            photos->push_back(currentPhoto);
+        }
+    }
+
+    // # current preview page, then adjacent pages
+    for(int offset : {0, 1, -1, 2, -2}){
+
+        int idPage = m_settings.pages.currentId + offset;
+        if(idPage < 0 || idPage >= m_pcPages.pages.size()){
+            continue;
+        }
+
+        for(const auto &set : m_pcPages.pages[idPage]->sets){
+            if(!set->source->isLoaded){
+                photos->push_back(set->source);
+            }
+        }
+    }
+
+    if(photos->size() > 0){
+        emit prioritize_photos_signal(photos);
+    }
+}
@@ -0,0 +1,84 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+/**
+ * \file PCMainUIBenchmarks.cpp
+ * \brief defines the benchmarks of PCMainUI, run from the command line
+ * \date 19/10/2026
+ */
+
+// local
+#include "PCMainUI.hpp"
+#include "DebugMessage.hpp"
+
+// Qt
+#include <QElapsedTimer>
+
+// std
+#include <algorithm>
+#include <functional>
+
+using namespace pc;
+
+void PCMainUI::benchmark_build_pages(){
+
+    // rebuild cost of the pages against the number of photos, transparent spaces are used as photos
+    const int nbRuns = 5;
+    auto median_time = [&](std::function<void()> prepare){
+        QVector<qint64> times;
+        for(int ii = 0; ii < nbRuns; ++ii){
+            prepare();
+            QElapsedTimer timer;
+            timer.start();
+            build_pages();
+            times.push_back(timer.nsecsElapsed());
+        }
+        std::sort(times.begin(), times.end());
+        return times[nbRuns/2] * 0.000001;
+    };
+
+    m_ui.update_global_settings(m_settings);
+    for(int nbPhotos : {100, 500, 1000, 2000, 5000}){
+
+        while(m_settings.photos.loaded->size() < nbPhotos){
+            m_settings.photos.loaded->push_back(std::make_shared<Photo>(Photo("", true)));
+            m_ui.settingsW.insert_individual_set(m_settings.photos.loaded->size()-1);
+        }
+        build_valid_sets();
+
+        int nbPhotosPerPage = std::max(1, m_settings.pages.positions.nbPhotos);
+        m_settings.pages.nb = (nbPhotos + nbPhotosPerPage - 1) / nbPhotosPerPage;
+
+        double fullTime      = median_time([&]{m_pcPages.pages.clear();});
+        double unchangedTime = median_time([]{});
+        double headerTime    = median_time([&]{m_settings.header.text.html = std::make_shared<QString>();});
+        double setsTime      = median_time([&]{m_settings.sets.text.html = std::make_shared<QString>();});
+
+        benchmark_report(QString("build_pages benchmark: photos %1 pages %2 | full rebuild %3 ms | unchanged %4 ms | header changed %5 ms | sets text changed %6 ms")
+                         .arg(nbPhotos).arg(m_settings.pages.nb).arg(fullTime).arg(unchangedTime).arg(headerTime).arg(setsTime));
+    }
+}
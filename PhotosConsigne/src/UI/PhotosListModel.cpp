@@ -0,0 +1,232 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file PhotosListModel.cpp
+ * \brief defines PhotosListModel
+ * \date 19/10/2026
+ */
+
+// local
+#include "PhotosListModel.hpp"
+#include "Counters.hpp"
+
+// Qt
+#include <QtConcurrent>
+#include <QImageReader>
+
+using namespace pc;
+
+PhotosListModel::PhotosListModel(QObject *parent) : QAbstractListModel(parent){
+
+
+    m_placeholderIcon = QPixmap(iconSize, iconSize);
+    m_placeholderIcon.fill(QColor(225,225,225));
+    m_whiteSpaceIcon = QPixmap(iconSize, iconSize);
+    m_whiteSpaceIcon.fill(Qt::white);
+
+    // icons are only a comfort for the list, keep the other threads for the thumbnails and the preview
+    m_iconsPool.setMaxThreadCount(1);
+
+    connect(this, &PhotosListModel::icon_computed_signal, this, &PhotosListModel::set_icon, Qt::QueuedConnection);
+}
+
+PhotosListModel::~PhotosListModel(){
+
+    m_iconsPool.clear();
+    m_iconsPool.waitForDone();
+}
+
+void PhotosListModel::update(SPhotos photos, const QVector<bool> &individualSets){
+
+    // compute new rows
+    QVector<Row> rows;
+    rows.reserve(photos->size());
+    for(int ii = 0; ii < photos->size(); ++ii){
+
+        Row row;
+        row.photo           = photos->at(ii);
+        row.pageId          = row.photo->pageId;
+        row.isADuplicate    = row.photo->isADuplicate;
+        row.isOnDocument    = row.photo->isOnDocument;
+        row.isRemoved       = row.photo->isRemoved;
+        row.individualSet   = individualSets[ii];
+        rows.push_back(std::move(row));
+    }
+
+    // # common photos at the beginning and at the end, a reloaded photo keeps the uid of the one it replaces
+    int minSize = std::min(m_rows.size(), rows.size());
+    int prefix = 0;
+    while(prefix < minSize && m_rows[prefix].photo->uid == rows[prefix].photo->uid){
+        ++prefix;
+    }
+    int suffix = 0;
+    while(suffix < minSize - prefix && m_rows[m_rows.size()-1-suffix].photo->uid == rows[rows.size()-1-suffix].photo->uid){
+        ++suffix;
+    }
+
+    // # removed rows
+    int endRemoved = m_rows.size() - suffix;
+    if(endRemoved > prefix){
+        beginRemoveRows(QModelIndex(), prefix, endRemoved-1);
+        for(int ii = prefix; ii < endRemoved; ++ii){
+            m_icons.remove(m_rows[ii].photo->uid);
+        }
+        m_rows.remove(prefix, endRemoved - prefix);
+        endRemoveRows();
+    }
+
+    // # inserted rows
+    int endInserted = rows.size() - suffix;
+    if(endInserted > prefix){
+        beginInsertRows(QModelIndex(), prefix, endInserted-1);
+        m_rows.insert(prefix, endInserted - prefix, Row());
+        for(int ii = prefix; ii < endInserted; ++ii){
+            m_rows[ii] = rows[ii];
+        }
+        endInsertRows();
+    }
+
+    // # modified rows, signaled by contiguous ranges
+    int startChanged = -1;
+    for(int ii = 0; ii <= rows.size(); ++ii){
+
+        bool changed = ii < rows.size() && !(m_rows[ii] == rows[ii]);
+        if(changed){
+            m_rows[ii] = std::move(rows[ii]);
+            if(startChanged == -1){
+                startChanged = ii;
+            }
+        }else if(startChanged != -1){
+            emit dataChanged(index(startChanged), index(ii-1), {Qt::DisplayRole, Qt::ForegroundRole, Qt::DecorationRole});
+            startChanged = -1;
+        }
+    }
+}
+
+int PhotosListModel::rowCount(const QModelIndex &parent) const{
+
+    if(parent.isValid()){
+        return 0;
+    }
+    return m_rows.size();
+}
+
+QVariant PhotosListModel::data(const QModelIndex &index, int role) const{
+
+    if(!index.isValid() || index.row() >= m_rows.size()){
+        return QVariant();
+    }
+
+    const Row &row = m_rows[index.row()];
+    switch(role){
+    case Qt::DisplayRole:{
+
+        QString ext = row.isADuplicate ? " (copie)" : "";
+        return QString::number(index.row()+1) + ". " + row.photo->namePhoto + ext + ((row.pageId > -1) ? " (p" + QString::number(row.pageId) + ")" : "");
+    }
+    case Qt::ForegroundRole:{
+
+        if(!row.isOnDocument && !row.isRemoved){
+            return QBrush(qRgb(255,0,0));
+        }else if(!row.isOnDocument){
+            return QBrush(qRgb(255,120,120));
+        }else if(row.isRemoved){
+            return QBrush(qRgb(127,180,255));
+        }else if(row.individualSet){
+            return QBrush(qRgb(0,0,255));
+        }
+        return QBrush(qRgb(0,106,255));
+    }
+    case Qt::DecorationRole:{
+
+        if(row.photo->isWhiteSpace){
+            return m_whiteSpaceIcon;
+        }
+
+        // only called for the visible rows
+        auto icon = m_icons.constFind(row.photo->uid);
+        bool upToDate = icon != m_icons.constEnd() && icon.value().thumbnailKey == row.photo->scaledPhoto.cacheKey();
+        Counters::hit(Counter::PhotoIconsHits, Counter::PhotoIconsMisses, upToDate);
+        if(!upToDate){
+            request_icon(row.photo, index.row());
+        }
+
+        return (icon != m_icons.constEnd()) ? icon.value().pixmap : m_placeholderIcon;
+    }
+    }
+
+    return QVariant();
+}
+
+void PhotosListModel::request_icon(const SPhoto &photo, int row) const{
+
+    quint64 key = photo->uid;
+    if(m_iconsRequested.contains(key)){
+        return;
+    }
+    m_iconsRequested.insert(key);
+
+    // photo members are read here on the UI thread
+    QImage thumbnail    = photo->scaledPhoto;
+    qint64 thumbnailKey = thumbnail.cacheKey();
+    QString path        = photo->pathPhoto;
+    int rotation        = photo->rotation;
+
+    PhotosListModel *model = const_cast<PhotosListModel*>(this);
+    QtConcurrent::run(&m_iconsPool, [=]{
+
+        QImage icon;
+        if(!thumbnail.isNull()){
+            icon = thumbnail.scaled(iconSize, iconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }else{ // thumbnail not decoded yet and no embedded one
+            QImageReader reader(path);
+            QSize size = reader.size();
+            if(size.isValid()){
+                reader.setScaledSize(size.scaled(iconSize, iconSize, Qt::KeepAspectRatio));
+            }
+            icon = reader.read().transformed(QTransform().rotate(rotation));
+        }
+
+        emit model->icon_computed_signal(key, row, thumbnailKey, icon);
+    });
+}
+
+void PhotosListModel::set_icon(quint64 photoUid, int row, qint64 thumbnailKey, QImage icon){
+
+    m_iconsRequested.remove(photoUid);
+
+    // photo may have been moved or removed from the list meanwhile, it is requested again at the next paint of its row
+    if(row >= m_rows.size() || m_rows[row].photo->uid != photoUid){
+        return;
+    }
+
+    // keep the placeholder if the photo can't be read, to not request it again at each paint
+    m_icons[photoUid] = Icon{thumbnailKey, icon.isNull() ? m_placeholderIcon : QPixmap::fromImage(icon)};
+    emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+}
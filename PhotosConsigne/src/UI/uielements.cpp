@@ -38,9 +38,14 @@
 #include <QDesktopServices>
 #include <QMessageBox>
 
+// std
+#include <algorithm>
+#include <cstdlib>
 
 // local
 #include "UIElements.hpp"
+#include "PDFGeneratorWorker.hpp"
+#include "DebugMessage.hpp"
 
 using namespace pc;
 
@@ -61,6 +66,7 @@ pc::UIElements::UIElements(QMainWindow *parent) : m_parent(parent) {
 
     // # right settings
     mainUI.vlRightSettings->addWidget(&settingsW);
+    StartupProfiler::step("widgets");
 
     // PCMainUI init uI
     // # definition
@@ -71,9 +77,15 @@ pc::UIElements::UIElements(QMainWindow *parent) : m_parent(parent) {
     // # buttons
     mainUI.pbAdd->hide();
     // # list photos
+    mainUI.lvPhotosList->setModel(&photosListModel);
+    mainUI.lvPhotosList->setIconSize(QSize(PhotosListModel::iconSize, PhotosListModel::iconSize));
     mainUI.twPhotosList->setTabEnabled(1,false); // list photos info tab
     // # list pages
     mainUI.twPagesList->setTabEnabled(1,false);  // list pages info tab
+    mainUI.lwPagesList->setIconSize(QSize(PDFGeneratorWorker::pageThumbnailSize, PDFGeneratorWorker::pageThumbnailSize));
+    m_pagesThumbnails.setMaxCost(500);
+    m_pagePlaceholder = QPixmap(PDFGeneratorWorker::pageThumbnailSize, PDFGeneratorWorker::pageThumbnailSize);
+    m_pagePlaceholder.fill(Qt::transparent);
     // # tabs middles
     mainUI.twMiddle->setTabEnabled(0, false);
 
@@ -81,19 +93,11 @@ pc::UIElements::UIElements(QMainWindow *parent) : m_parent(parent) {
 
     // mainUI connections
     connect(mainUI.pbDisplayOnlyPhotos, &QPushButton::clicked, this, [&]{
-        Utility::safe_init_double_spinbox_value(settingsW.globalSetW.styleW.ui.dsbRatioPC, 1.);
-        for(auto &&setW : settingsW.setsLoadedW){
-            Utility::safe_init_double_spinbox_value(setW->styleW.ui.dsbRatioPC, 1.);
-            Utility::safe_init_slider_value(setW->styleW.ui.hsRatioPC, 10000.);
-        }
+        settingsW.set_all_sets_ratio(1.);
         ask_for_update(true);
     });
     connect(mainUI.pbDisplayOnlyTextes, &QPushButton::clicked, this, [&]{
-        Utility::safe_init_double_spinbox_value(settingsW.globalSetW.styleW.ui.dsbRatioPC, 0.);
-        for(auto &&setW : settingsW.setsLoadedW){
-            Utility::safe_init_double_spinbox_value(setW->styleW.ui.dsbRatioPC, 0.);
-            Utility::safe_init_slider_value(setW->styleW.ui.hsRatioPC, 0.);
-        }
+        settingsW.set_all_sets_ratio(0.);
         ask_for_update(true);
     });
 
@@ -134,7 +138,7 @@ void UIElements::ask_for_update(bool displayZones){
     emit settings_updated_signal();
 }
 
-void UIElements::write_to_xml(QXmlStreamWriter &xml) const{
+void UIElements::write_to_xml(QXmlStreamWriter &xml, bool onlyOverrides) const{
 
     xml.writeStartElement("Document");
     xml.writeAttribute("orientation", QString::number(mainUI.cbOrientation->currentIndex()));
@@ -144,7 +148,7 @@ void UIElements::write_to_xml(QXmlStreamWriter &xml) const{
     xml.writeAttribute("dpi", QString::number(mainUI.cbDPI->currentIndex()));
     xml.writeAttribute("onlyCurrPage", QString::number(mainUI.cbSaveOnlyCurrentPage->isChecked() ? 1 : 0));
     xml.writeAttribute("blackAndWhite", QString::number(mainUI.cbBAndW->isChecked() ? 1 : 0));
-    settingsW.write_to_xml(xml);
+    settingsW.write_to_xml(xml, onlyOverrides);
     xml.writeEndElement();
 }
 
@@ -215,6 +219,7 @@ void UIElements::display_help_window(){
         }
     });
 
+    connect(help.pbDiagnostics, &QPushButton::clicked, this, &UIElements::diagnostics_window_asked_signal);
     connect(help.pbReturn, &QPushButton::clicked, this, [=]{
         helpW->hide();
     });
@@ -240,10 +245,10 @@ void UIElements::update_global_settings(GlobalSettings &settings) const{
     settings.pages.nb = mainUI.sbNbPages->value();
 
     // # header
-    settingsW.headerW.update_settings(settings.header);
+    settingsW.update_header_settings(settings.header);
 
     // # footer
-    settingsW.footerW.update_settings(settings.footer);
+    settingsW.update_footer_settings(settings.footer);
 }
 
 
@@ -270,13 +275,13 @@ void UIElements::set_ui_state_for_adding_photos(bool state){
     // ## pdf
     mainUI.pbSavePDF->setEnabled(state);
     // # photos list
-    mainUI.lwPhotosList->setEnabled(state);
+    mainUI.lvPhotosList->setEnabled(state);
     // # pages list
     mainUI.lwPagesList->setEnabled(state);
     // # document
     mainUI.tabWDocument->setEnabled(state);
 
-    if( mainUI.lwPhotosList->count()> 0){
+    if(photosListModel.rowCount() > 0){
         mainUI.twMiddle->setTabEnabled(0, true);
     }
 }
@@ -301,62 +306,46 @@ void UIElements::set_ui_state_for_loading_work(bool state){
     // ## pdf
     mainUI.pbSavePDF->setEnabled(state);
     // # photos list
-    mainUI.lwPhotosList->setEnabled(state);
+    mainUI.lvPhotosList->setEnabled(state);
     // # pages list
     mainUI.lwPagesList->setEnabled(state);
     // # document
     mainUI.tabWDocument->setEnabled(state);
 
-    if( mainUI.lwPhotosList->count()> 0){
+    if(photosListModel.rowCount() > 0){
         mainUI.twMiddle->setTabEnabled(0, true);
     }
 }
 
 void UIElements::update_photos_list(const GlobalSettings &settings){
 
-    mainUI.lwPhotosList->blockSignals(true);
-
     SPhotos photos = settings.photos.loaded;
-
-    mainUI.lwPhotosList->clear();
     mainUI.twPhotosList->setTabText(1, QString::number(photos->size()));
 
+    QVector<bool> individualSets;
+    individualSets.reserve(photos->size());
     for(int ii = 0; ii < photos->size(); ++ii){
+        individualSets.push_back(settingsW.setsLoaded[ii]->enabled);
+    }
+    photosListModel.update(photos, individualSets);
 
-        QString ext = photos->at(ii)->isADuplicate ? " (copie)" : "";
-        mainUI.lwPhotosList->addItem(QString::number(ii+1) + ". " + photos->at(ii)->namePhoto + ext + ((photos->at(ii)->pageId > -1) ? " (p" + QString::number(photos->at(ii)->pageId) + ")" : ""));
-
-        bool individual = settingsW.setsLoadedW[ii]->ui.cbEnableIndividualConsign->isChecked();
-        QBrush brush = mainUI.lwPhotosList->item(ii)->foreground();
-        SPhoto photo = photos->at(ii);
-
-        if(!photo->isOnDocument && !photo->isRemoved){
-            brush.setColor(QRgb(qRgb(255,0,0)));
-        }else if(!photo->isOnDocument){
-            brush.setColor(QRgb(qRgb(255,120,120)));
-        }else if(photo->isRemoved){
-            brush.setColor(QRgb(qRgb(127,180,255)));
-        }else if(individual){
-            brush.setColor(QRgb(qRgb(0,0,255)));
+    if(settings.photos.currentId < photos->size()){
+        if(photos->at(settings.photos.currentId)->isRemoved){
+            mainUI.pbRemove->hide();
+            mainUI.pbAdd->show();
         }else{
-            brush.setColor(QRgb(qRgb(0,106,255)));
+            mainUI.pbRemove->show();
+            mainUI.pbAdd->hide();
         }
-
-        if(ii == settings.photos.currentId){
-            if(photo->isRemoved){
-                mainUI.pbRemove->hide();
-                mainUI.pbAdd->show();
-            }else{
-                mainUI.pbRemove->show();
-                mainUI.pbAdd->hide();
-            }
-        }
-
-        mainUI.lwPhotosList->item(ii)->setForeground(brush);
     }
 
-    mainUI.lwPhotosList->setCurrentRow(settings.photos.currentId);
-    mainUI.lwPhotosList->blockSignals(false);
+    // the view is repainted manually since the selection signals are blocked
+    QModelIndex currentIndex = photosListModel.index(settings.photos.currentId);
+    mainUI.lvPhotosList->selectionModel()->blockSignals(true);
+    mainUI.lvPhotosList->selectionModel()->setCurrentIndex(currentIndex, QItemSelectionModel::ClearAndSelect);
+    mainUI.lvPhotosList->selectionModel()->blockSignals(false);
+    mainUI.lvPhotosList->scrollTo(currentIndex);
+    mainUI.lvPhotosList->viewport()->update();
 }
 
 void UIElements::update_pages_list(const PCPages &pcPages){
@@ -391,6 +380,51 @@ void UIElements::update_pages_list(const PCPages &pcPages){
     mainUI.lwPagesList->blockSignals(false);
 }
 
+void UIElements::update_pages_thumbnails(const PCPages &pcPages, int currentPageId, QVector<int> &pagesToRender, QVector<uint> &pagesToRenderHash){
+
+    // the texts may display the number of pages and of photos
+    int totalSets = 0;
+    for(const auto &page : pcPages.pages){
+        totalSets += page->sets.size();
+    }
+
+    m_pagesHash.resize(pcPages.pages.size());
+    for(int ii = 0; ii < pcPages.pages.size() && ii < mainUI.lwPagesList->count(); ++ii){
+
+        m_pagesHash[ii] = qHash(totalSets, qHash(pcPages.pages.size(), pcPages.page_hash(ii)));
+
+        QPixmap *thumbnail = m_pagesThumbnails.object(m_pagesHash[ii]);
+        Counters::hit(Counter::PageThumbnailsHits, Counter::PageThumbnailsMisses, thumbnail != nullptr);
+        if(thumbnail != nullptr){
+            mainUI.lwPagesList->item(ii)->setIcon(*thumbnail);
+        }else{
+            mainUI.lwPagesList->item(ii)->setIcon(m_pagePlaceholder);
+            pagesToRender.push_back(ii);
+        }
+    }
+
+    std::sort(pagesToRender.begin(), pagesToRender.end(), [&](int id1, int id2){
+        return std::abs(id1 - currentPageId) < std::abs(id2 - currentPageId);
+    });
+
+    pagesToRenderHash.reserve(pagesToRender.size());
+    for(int id : pagesToRender){
+        pagesToRenderHash.push_back(m_pagesHash[id]);
+    }
+}
+
+void UIElements::set_page_thumbnail(uint pageHash, QImage thumbnail){
+
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(thumbnail));
+    for(int ii = 0; ii < m_pagesHash.size() && ii < mainUI.lwPagesList->count(); ++ii){
+        if(m_pagesHash[ii] == pageHash){
+            mainUI.lwPagesList->item(ii)->setIcon(*pixmap);
+        }
+    }
+
+    m_pagesThumbnails.insert(pageHash, pixmap);
+}
+
 void UIElements::update_UI(const GlobalSettings &settings){
 
     // update defition/dim labels
@@ -423,15 +457,30 @@ void UIElements::update_UI(const GlobalSettings &settings){
         QString textInfo = "<p><b>Chemin:</b> "  + path + "<br /><b>Taille photo:</b> " +
                 QString::number(currentDisplayedPhoto->info.size()*0.000001, 'f', 2 ) + "Mo - <b>Dimensions:</b> " +
                 QString::number(currentDisplayedPhoto->size().width())  + "x" +
-                QString::number(currentDisplayedPhoto->size().height()) + "</p>";
+                QString::number(currentDisplayedPhoto->size().height());
+
+        const PhotoMetadata &metadata = currentDisplayedPhoto->metadata;
+        if(metadata.captureTime.isValid()){
+            textInfo += "<br /><b>Prise de vue:</b> " + metadata.captureTime.toString("dd/MM/yyyy HH:mm");
+        }
+        if(metadata.camera().size() > 0){
+            textInfo += (metadata.captureTime.isValid() ? " - <b>Appareil:</b> " : "<br /><b>Appareil:</b> ") + metadata.camera();
+        }
+        textInfo += "</p>";
         mainUI.laPhotoInfo->setTextFormat(Qt::RichText);
         mainUI.laPhotoInfo->setText(textInfo);
     }
 
     // header
-    settingsW.headerW.ui.frameHeader->setEnabled(settingsW.headerW.ui.cbEnableHeader->isChecked());
+    if(settingsW.header_w_created()){
+        HeaderW &headerW = settingsW.header_w();
+        headerW.ui.frameHeader->setEnabled(headerW.ui.cbEnableHeader->isChecked());
+    }
     // footer
-    settingsW.footerW.ui.frameFooter->setEnabled(settingsW.footerW.ui.cbEnableFooter->isChecked());
+    if(settingsW.footer_w_created()){
+        FooterW &footerW = settingsW.footer_w();
+        footerW.ui.frameFooter->setEnabled(footerW.ui.cbEnableFooter->isChecked());
+    }
 
 
     // pages
@@ -444,8 +493,9 @@ void UIElements::update_UI(const GlobalSettings &settings){
     }
 
     // sets
-    for(auto &&setW : settingsW.setsLoadedW){
-        setW->ui.frameSet->setEnabled(setW->ui.cbEnableIndividualConsign->isChecked());
+    if(settingsW.individual_set_w_created()){
+        SetW &setW = settingsW.individual_set_w();
+        setW.ui.frameSet->setEnabled(setW.ui.cbEnableIndividualConsign->isChecked());
     }
 
     Utility::safe_init_spinbox_value(mainUI.sbOrder, settings.photos.currentId);
@@ -463,62 +513,26 @@ void UIElements::update_UI(const GlobalSettings &settings){
 
 void UIElements::add_resource_from_xml(QUrl url, QImage image){
 
-    settingsW.headerW.richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
-    settingsW.footerW.richTextW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
-
-    for(auto &&set : settingsW.setsLoadedW){
-        set->textW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
-    }
+    settingsW.add_lazy_editors_resource(url, image);
     settingsW.globalSetW.textW.textEdit()->document()->addResource(QTextDocument::ImageResource, url, image);
 }
 
 void UIElements::display_current_individual_set_ui(const GlobalSettings &settings){
 
-    if(settingsW.setsValidedW.size() == 0){ // empty
+    if(settingsW.setsValided.size() == 0){ // empty
+        if(settingsW.individual_set_w_created()){
+            settingsW.individual_set_w().hide();
+        }
         return;
     }
 
-    if(settings.sets.currentId >= settingsW.setsValidedW.size()){ // id too big
+    if(settings.sets.currentId >= settingsW.setsValided.size()){ // id too big
         qWarning() << "-ERROR: display_current_individual_set_ui  " << settings.sets.currentId;
         return;
     }
 
-    int currentVisiblesW = 0;
-    for(int ii = 0; ii < settingsW.setsLoadedW.size(); ++ii){
-        if(!settingsW.setsLoadedW[ii]->isHidden()){
-            ++currentVisiblesW;
-        }
-    }
-
-    if(currentVisiblesW > 1){
-        for(auto &&w : settingsW.setsLoadedW){
-            w->hide();
-        }
-    }
-
-    if(currentVisiblesW == 1){
-
-        int currentShownW = 0;
-        int curretShownId = 0;
-        for(int ii = 0; ii < settingsW.setsLoadedW.size(); ++ii){
-            if(!settingsW.setsLoadedW[ii]->isHidden()){
-                currentShownW = settingsW.setsLoadedW[ii]->id;
-                curretShownId = ii;
-                break;
-            }
-        }
-
-        if(settingsW.setsValidedW[settings.sets.currentId]->id == currentShownW){
-            return;
-        }
-
-        settingsW.setsLoadedW[curretShownId]->hide();
-        settingsW.setsValidedW[settings.sets.currentId]->show();
-    }else{
-        settingsW.setsValidedW[settings.sets.currentId]->show();
-    }
-
-    settingsW.setsValidedW[settings.sets.currentId]->show();
+    settingsW.bind_individual_set(settingsW.setsValided[settings.sets.currentId]);
+    settingsW.individual_set_w().show();
     settingsW.ui.tbRight->setItemText(3, "ENSEMBLE N°" + QString::number(settings.sets.currentId+1));
 }
 
@@ -26,13 +26,13 @@
 
 // local
 #include "Utility.hpp"
+#include "Trace.hpp"
 
 using namespace pc;
 
 QString Drawing::format_html_for_generation(QString html, pc::ExtraPCInfo infos){
 
-//    QElapsedTimer timer;
-//    timer.start();
+    TraceSpan span("format_html_for_generation");
 
     int index = 0;
 //    qDebug() << "HTML BEFORE\n " << html;
@@ -95,7 +95,28 @@ QString Drawing::format_html_for_generation(QString html, pc::ExtraPCInfo infos)
         if(index == -1)
             break;
         html = html.remove(index, 12);
-        html = html.insert(index, infos.fileInfo.lastModified().toString("dd/MM/yyyy"));
+        // capture date from the EXIF headers, last modification of the file if missing
+        QDateTime datePhoto = infos.photoMetadata.captureTime.isValid() ? infos.photoMetadata.captureTime : infos.fileDate;
+        html = html.insert(index, datePhoto.toString("dd/MM/yyyy"));
+    }
+
+    index = 0;
+    while(index != -1){
+        index = html.indexOf(QString("$heure_photo$"));
+        if(index == -1)
+            break;
+        html = html.remove(index, 13);
+        QDateTime datePhoto = infos.photoMetadata.captureTime.isValid() ? infos.photoMetadata.captureTime : infos.fileDate;
+        html = html.insert(index, datePhoto.toString("HH:mm"));
+    }
+
+    index = 0;
+    while(index != -1){
+        index = html.indexOf(QString("$appareil_photo$"));
+        if(index == -1)
+            break;
+        html = html.remove(index, 16);
+        html = html.insert(index, infos.photoMetadata.camera());
     }
 
     index = 0;
@@ -190,7 +211,6 @@ QString Drawing::format_html_for_generation(QString html, pc::ExtraPCInfo infos)
     }
 
     //        qDebug() << html;
-//    qDebug() << "Format html took" << timer.elapsed() << "milliseconds";
 //    qDebug() << "HTML AFTER\n " << html << "\n";
     return html;
 }
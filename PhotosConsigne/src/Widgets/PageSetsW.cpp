@@ -35,11 +35,18 @@
 
 // local
 #include "PageSetsW.hpp"
+#include "DebugMessage.hpp"
+
+// Qt
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
 
 using namespace pc;
 
 bool PageSetsW::posLoaded = false;
 QVector<SetsPositionSettings> PageSetsW::predefPositions;
+QVector<QIcon> PageSetsW::predefIcons;
 
 PageSetsW::PageSetsW() : SettingsW(){
 
@@ -189,112 +196,244 @@ PageSetsW::PageSetsW() : SettingsW(){
     read_pos_files();
 }
 
-void PageSetsW::read_pos_files(){
+bool PageSetsW::read_pos_file(const QString &path, SetsPositionSettings &pos){
 
-    if(!posLoaded){
-        predefPositions.clear();
-        QDirIterator dirIt(QCoreApplication::applicationDirPath() + "/data/positions",QDirIterator::Subdirectories);
-        while (dirIt.hasNext()) {
-            dirIt.next();
-            if (QFileInfo(dirIt.filePath()).isFile()){
-                if (QFileInfo(dirIt.filePath()).suffix() == "pos"){
-
-                    QFile file(dirIt.filePath());
-                    if(!file.open(QIODevice::ReadOnly)){
-                        continue;
-                    }
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
 
-                    SetsPositionSettings pos;
-
-                    bool invalidFile = false;
-                    QTextStream in(&file);
-                    QString line;
-                    int currentLine = 0;
-                    while (in.readLineInto(&line)) {
-
-                        if(line.size() == 0){
-                            break;
-                        }
-
-                        if(currentLine==0){ // mode
-                            pos.customMode = (line == "custom");
-                        }else if(currentLine==1){ // nb photos
-                            pos.nbPhotos = line.toInt();
-                        }else if(currentLine==2){ // size grid
-                            QStringList size = line.split('x');
-                            if(size.size() !=2){
-                                invalidFile = true;
-                                break;
-                            }
-                            pos.nbPhotosH = size[0].toInt();
-                            pos.nbPhotosV = size[1].toInt();
-                        }else if(pos.customMode){ // custom mode -> positions photos : p 1:1 6:4
-
-                            if(pos.relativePosCustom.size() == pos.nbPhotos){
-                                break;
-                            }
-
-                            QStringList parts = line.split(" ");
-                            if(parts.size() != 3 ){
-                                invalidFile = true;
-                                break;
-                            }
-
-                            QStringList topLeft  = parts[1].split(':');
-                            QStringList sizeRect = parts[2].split(':');
-
-                            if(topLeft.size() != 2 || sizeRect.size() != 2){
-                                invalidFile = true;
-                                break;
-                            }
-
-                            qreal x = topLeft[0].toDouble();
-                            qreal y = topLeft[1].toDouble();
-                            qreal w = sizeRect[0].toDouble();
-                            qreal h = sizeRect[1].toDouble();
-
-                            if((x+w) > 1. || (y+h) > 1.){
-                                invalidFile = true;
-                                break;
-                            }
-
-                            pos.relativePosCustom.push_back(QRectF(x,y,w,h));
-
-                        }else{ // grid mode -> size columns and lines -> l 0.2 | c 0.2
-
-                            QStringList parts = line.split(" ");
-                            if(parts.size() != 2){
-                                invalidFile = true;
-                                break;
-                            }
-
-                            if(parts[0] == "l"){ // line
-
-                                if(pos.linesHeight.size() == pos.nbPhotosV){
-                                    break;
-                                }
-
-                                pos.linesHeight.push_back(parts[1].toDouble());
-
-                            }else if(parts[0] == "c"){ // column
-
-                                if(pos.columnsWidth.size() == pos.nbPhotosH){
-                                    break;
-                                }
-                                pos.columnsWidth.push_back(parts[1].toDouble());
-                            }
-                        }
-
-                        ++currentLine;
-                    }
+    bool invalidFile = false;
+    QTextStream in(&file);
+    QString line;
+    int currentLine = 0;
+    while (in.readLineInto(&line)) {
 
-                    if(!invalidFile){
-                        predefPositions.push_back(std::move(pos));
-                    }
+        if(line.size() == 0){
+            break;
+        }
+
+        if(currentLine==0){ // mode
+            pos.customMode = (line == "custom");
+        }else if(currentLine==1){ // nb photos
+            pos.nbPhotos = line.toInt();
+        }else if(currentLine==2){ // size grid
+            QStringList size = line.split('x');
+            if(size.size() !=2){
+                invalidFile = true;
+                break;
+            }
+            pos.nbPhotosH = size[0].toInt();
+            pos.nbPhotosV = size[1].toInt();
+        }else if(pos.customMode){ // custom mode -> positions photos : p 1:1 6:4
+
+            if(pos.relativePosCustom.size() == pos.nbPhotos){
+                break;
+            }
+
+            QStringList parts = line.split(" ");
+            if(parts.size() != 3 ){
+                invalidFile = true;
+                break;
+            }
+
+            QStringList topLeft  = parts[1].split(':');
+            QStringList sizeRect = parts[2].split(':');
+
+            if(topLeft.size() != 2 || sizeRect.size() != 2){
+                invalidFile = true;
+                break;
+            }
+
+            qreal x = topLeft[0].toDouble();
+            qreal y = topLeft[1].toDouble();
+            qreal w = sizeRect[0].toDouble();
+            qreal h = sizeRect[1].toDouble();
+
+            if((x+w) > 1. || (y+h) > 1.){
+                invalidFile = true;
+                break;
+            }
+
+            pos.relativePosCustom.push_back(QRectF(x,y,w,h));
+
+        }else{ // grid mode -> size columns and lines -> l 0.2 | c 0.2
+
+            QStringList parts = line.split(" ");
+            if(parts.size() != 2){
+                invalidFile = true;
+                break;
+            }
+
+            if(parts[0] == "l"){ // line
+
+                if(pos.linesHeight.size() == pos.nbPhotosV){
+                    break;
+                }
+
+                pos.linesHeight.push_back(parts[1].toDouble());
+
+            }else if(parts[0] == "c"){ // column
+
+                if(pos.columnsWidth.size() == pos.nbPhotosH){
+                    break;
+                }
+                pos.columnsWidth.push_back(parts[1].toDouble());
+            }
+        }
+
+        ++currentLine;
+    }
+
+    return !invalidFile;
+}
+
+void PageSetsW::load_predef_positions(){
+
+    // stamp of the library: modification times of the application and of the positions directories,
+    // the files themselves are only listed when the index has to be rebuilt
+    const QString positionsDir = QCoreApplication::applicationDirPath() + "/data/positions";
+    QStringList stamp;
+    stamp << QString::number(QFileInfo(QCoreApplication::applicationFilePath()).lastModified().toMSecsSinceEpoch());
+    stamp << positionsDir + "|" + QString::number(QFileInfo(positionsDir).lastModified().toMSecsSinceEpoch());
+    QDirIterator dirsIt(positionsDir, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (dirsIt.hasNext()) {
+        dirsIt.next();
+        stamp << dirsIt.filePath() + "|" + QString::number(dirsIt.fileInfo().lastModified().toMSecsSinceEpoch());
+    }
+    stamp.sort();
+
+    // read the cached index if the library is unchanged
+    predefPositions.clear();
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/positions.idx";
+    QFile cacheFile(cachePath);
+    if(cacheFile.open(QIODevice::ReadOnly)){
+
+        QDataStream in(&cacheFile);
+        in.setVersion(QDataStream::Qt_5_6);
+        quint32 version;
+        QStringList cachedStamp;
+        in >> version >> cachedStamp;
+        if(version == posIndexVersion && cachedStamp == stamp){
+
+            quint32 nbPositions;
+            in >> nbPositions;
+            for(quint32 ii = 0; ii < nbPositions && in.status() == QDataStream::Ok; ++ii){
+                SetsPositionSettings pos;
+                in >> pos.customMode >> pos.nbPhotos >> pos.nbPhotosH >> pos.nbPhotosV >> pos.columnsWidth >> pos.linesHeight >> pos.relativePosCustom;
+                predefPositions.push_back(std::move(pos));
+            }
+
+            if(in.status() != QDataStream::Ok){
+                predefPositions.clear();
+            }
+        }
+        cacheFile.close();
+    }
+
+    // parse the files and write the index
+    if(predefPositions.size() == 0){
+
+        QStringList filesPath;
+        QDirIterator filesIt(positionsDir, {"*.pos"}, QDir::Files, QDirIterator::Subdirectories);
+        while (filesIt.hasNext()) {
+            filesPath << filesIt.next();
+        }
+        filesPath.sort();
+
+        for(const auto &filePath : filesPath){
+            SetsPositionSettings pos;
+            if(read_pos_file(filePath, pos)){
+                predefPositions.push_back(std::move(pos));
+            }
+        }
+
+        QDir().mkpath(QFileInfo(cachePath).absolutePath());
+        QSaveFile indexFile(cachePath);
+        if(indexFile.open(QIODevice::WriteOnly)){
+
+            QDataStream out(&indexFile);
+            out.setVersion(QDataStream::Qt_5_6);
+            out << posIndexVersion << stamp << static_cast<quint32>(predefPositions.size());
+            for(const auto &pos : predefPositions){
+                out << pos.customMode << pos.nbPhotos << pos.nbPhotosH << pos.nbPhotosV << pos.columnsWidth << pos.linesHeight << pos.relativePosCustom;
+            }
+            indexFile.commit();
+        }
+    }
+
+    // icons are shared by all the pages widgets
+    predefIcons.clear();
+    predefIcons.reserve(predefPositions.size());
+    for(const auto &pos : predefPositions){
+        predefIcons.push_back(predef_position_icon(pos));
+    }
+}
+
+QIcon PageSetsW::predef_position_icon(const SetsPositionSettings &pos){
+
+    QImage iconImg(140,140, QImage::Format_ARGB32);
+    QSize interSize(120,120);
+    iconImg.fill(qRgba(255,255,255,0));
+
+    QPainter painter(&iconImg);
+    if(pos.customMode){
+        for(int jj = 0; jj < pos.relativePosCustom.size(); ++jj){
+
+            const QRectF &rect = pos.relativePosCustom[jj];
+            QRect setRect(static_cast<int>(rect.x()*interSize.width()   + (iconImg.width()-interSize.width())*0.5),
+                          static_cast<int>(rect.y()*interSize.height()  + (iconImg.height()-interSize.height())*0.5),
+                          static_cast<int>((rect.width())*interSize.width()),
+                          static_cast<int>((rect.height())*interSize.height()));
+
+            painter.fillRect(setRect, QBrush(UIColors[jj%UIColors.size()]));
+            painter.setPen(Qt::black);
+            painter.drawRect(setRect);
+        }
+    }else{
+
+        int currentPhoto = 0;
+
+        qreal offsetY = (iconImg.height()-interSize.height())*0.5;
+        for(int jj = 0; jj < pos.nbPhotosV; ++jj){
+
+            qreal height= pos.linesHeight[jj];
+            qreal offsetX = (iconImg.width()-interSize.width())*0.5;
+            for(int kk = 0; kk < pos.nbPhotosH; ++kk){
+                if(currentPhoto == pos.nbPhotos){
+                    break;
                 }
+
+                qreal width = pos.columnsWidth[kk];
+                QRect setRect(static_cast<int>(offsetX), static_cast<int>(offsetY), static_cast<int>(width*interSize.width()), static_cast<int>(height*interSize.height()));
+                painter.fillRect(setRect, QBrush(UIColors[currentPhoto%UIColors.size()]));
+                painter.setPen(Qt::black);
+                painter.drawRect(setRect);
+
+                ++currentPhoto;
+                offsetX += width*interSize.width();
+
             }
+            offsetY += height*interSize.height();
         }
     }
+
+//        QFont font;
+//        font.setPointSizeF(20.);
+//        painter.setPen(Qt::white);
+//        painter.setFont(font);
+//        painter.drawText(20,40, pos.customMode ? "P" : "G");
+    painter.end();
+
+    return QIcon(QPixmap::fromImage(iconImg));
+}
+
+void PageSetsW::read_pos_files(){
+
+    if(!posLoaded){
+        load_predef_positions();
+        StartupProfiler::step("predefined positions");
+    }
     posLoaded = true;
 
     // reset ui
@@ -341,62 +480,7 @@ void PageSetsW::read_pos_files(){
         button->setMaximumHeight(60);
         button->setMaximumWidth(60);
         button->setIconSize(QSize(60,60));
-
-
-        QImage iconImg(140,140, QImage::Format_ARGB32);
-        QSize interSize(120,120);
-        iconImg.fill(qRgba(255,255,255,0));
-
-        QPainter painter(&iconImg);
-        if(predefPositions[ii].customMode){
-            for(int jj = 0; jj < predefPositions[ii].relativePosCustom.size(); ++jj){
-
-                const QRectF &rect = predefPositions[ii].relativePosCustom[jj];
-                QRect setRect(static_cast<int>(rect.x()*interSize.width()   + (iconImg.width()-interSize.width())*0.5),
-                              static_cast<int>(rect.y()*interSize.height()  + (iconImg.height()-interSize.height())*0.5),
-                              static_cast<int>((rect.width())*interSize.width()),
-                              static_cast<int>((rect.height())*interSize.height()));
-
-                painter.fillRect(setRect, QBrush(UIColors[jj%UIColors.size()]));
-                painter.setPen(Qt::black);
-                painter.drawRect(setRect);
-            }
-        }else{
-
-            int currentPhoto = 0;
-
-            qreal offsetY = (iconImg.height()-interSize.height())*0.5;
-            for(int jj = 0; jj < predefPositions[ii].nbPhotosV; ++jj){
-
-                qreal height= predefPositions[ii].linesHeight[jj];
-                qreal offsetX = (iconImg.width()-interSize.width())*0.5;
-                for(int kk = 0; kk < predefPositions[ii].nbPhotosH; ++kk){
-                    if(currentPhoto == predefPositions[ii].nbPhotos){
-                        break;
-                    }
-
-                    qreal width = predefPositions[ii].columnsWidth[kk];
-                    QRect setRect(static_cast<int>(offsetX), static_cast<int>(offsetY), static_cast<int>(width*interSize.width()), static_cast<int>(height*interSize.height()));
-                    painter.fillRect(setRect, QBrush(UIColors[currentPhoto%UIColors.size()]));
-                    painter.setPen(Qt::black);
-                    painter.drawRect(setRect);
-
-                    ++currentPhoto;
-                    offsetX += width*interSize.width();
-
-                }
-                offsetY += height*interSize.height();
-            }
-        }
-
-//        QFont font;
-//        font.setPointSizeF(20.);
-//        painter.setPen(Qt::white);
-//        painter.setFont(font);
-//        painter.drawText(20,40, predefPositions[ii].customMode ? "P" : "G");
-
-        QIcon icon(QPixmap::fromImage(iconImg));
-        button->setIcon(icon);
+        button->setIcon(predefIcons[ii]);
 
         ui.glPreDef->addWidget(button, currentCol, currentLine, Qt::AlignmentFlag::AlignCenter);
         predefButtons.push_back(button);
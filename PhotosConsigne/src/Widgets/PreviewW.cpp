@@ -32,6 +32,10 @@
 #include <QCoreApplication>
 #include <QPainter>
 
+// std
+#include <algorithm>
+#include <cmath>
+
 using namespace pc;
 
 
@@ -68,6 +72,15 @@ PreviewW::PreviewW(){
         update();
     });
 
+    // the preview is rendered at the widget size, a larger one is asked once the resizing is done
+    m_resizeTimer.setSingleShot(true);
+    connect(&m_resizeTimer, &QTimer::timeout, this, [&]{
+        QSizeF fitSize = page_rect().size()/m_zoom*devicePixelRatioF();
+        if(!m_image.isNull() && fitSize.width() > m_image.width()*1.1){
+            emit larger_preview_needed_signal();
+        }
+    });
+
     m_worker = std::make_unique<PreviewWorker>();
     connect(m_worker.get(), &PreviewWorker::update_preview_signal, this, [=]{
         update();
@@ -87,6 +100,49 @@ PreviewW::~PreviewW(){
 
 void PreviewW::set_page(SPCPage previewPage){
     m_previewPage       = previewPage;
+    m_tiles.clear();
+    m_requestedTiles.clear();
+}
+
+void PreviewW::set_max_page_size(QSize maxPageSize){
+    m_maxPageSize = maxPageSize;
+}
+
+void PreviewW::set_tile(SPCPage previewPage, QSize pageSize, QRect tile, QImage image){
+
+    if(previewPage != m_previewPage){
+        return;
+    }
+
+    QString key = tile_key(pageSize, tile.topLeft());
+    m_requestedTiles.remove(key);
+    int cost = std::max(1, image.bytesPerLine()*image.height()/1024);
+    m_tiles.insert(key, new QImage(std::move(image)), cost);
+    update();
+}
+
+QString PreviewW::tile_key(const QSize &pageSize, const QPoint &tilePos){
+    return QString::number(pageSize.width()) + "x" + QString::number(pageSize.height()) + ":" +
+           QString::number(tilePos.x()) + "," + QString::number(tilePos.y());
+}
+
+QRectF PreviewW::page_rect() const{
+
+    QSizeF size = QSizeF(m_image.size()).scaled(QSizeF(width()-2, height()-2), Qt::KeepAspectRatio)*m_zoom;
+    return QRectF(QPointF(width()*0.5 - m_zoomCenter.x()*size.width(), height()*0.5 - m_zoomCenter.y()*size.height()), size);
+}
+
+void PreviewW::clamp_zoom_center(){
+
+    QRectF page = page_rect();
+    auto clamp_axis = [](qreal center, qreal pageLength, qreal widgetLength){
+        if(pageLength <= widgetLength){
+            return 0.5;
+        }
+        const qreal half = 0.5*widgetLength/pageLength;
+        return qBound(half, center, 1. - half);
+    };
+    m_zoomCenter = QPointF(clamp_axis(m_zoomCenter.x(), page.width(), width()), clamp_axis(m_zoomCenter.y(), page.height(), height()));
 }
 
 void PreviewW::set_current_pc(int idPC){
@@ -129,6 +185,15 @@ void PreviewW::set_current_pc(int idPC){
 
 void PreviewW::mousePressEvent(QMouseEvent *ev){
 
+    if(ev->button() == Qt::RightButton || ev->button() == Qt::MiddleButton){ // the zoomed page is moved by dragging
+        m_dragging = m_zoom > 1.;
+        m_dragPos  = ev->pos();
+        if(m_dragging){
+            setCursor(Qt::ClosedHandCursor);
+        }
+        return;
+    }
+
     bool inside = m_imageRect.contains(ev->pos());
     if(inside){ // click inside preview image
 
@@ -189,12 +254,124 @@ void PreviewW::mousePressEvent(QMouseEvent *ev){
     }
 }
 
+void PreviewW::mouseMoveEvent(QMouseEvent *ev){
+
+    if(!m_dragging){
+        PhotoW::mouseMoveEvent(ev);
+        return;
+    }
+
+    QRectF page = page_rect();
+    QPoint delta = ev->pos() - m_dragPos;
+    m_dragPos = ev->pos();
+    m_zoomCenter -= QPointF(delta.x()/page.width(), delta.y()/page.height());
+    clamp_zoom_center();
+    update();
+}
+
+void PreviewW::mouseReleaseEvent(QMouseEvent *ev){
+
+    if(m_dragging){
+        m_dragging = false;
+        unsetCursor();
+    }
+    PhotoW::mouseReleaseEvent(ev);
+}
+
+void PreviewW::wheelEvent(QWheelEvent *ev){
+
+    if(m_image.isNull() || ev->angleDelta().y() == 0){
+        ev->ignore();
+        return;
+    }
+    ev->accept();
+
+    // zoom up to the largest page size, around the cursor
+    QRectF page = page_rect();
+    qreal maxZoom = 1.;
+    if(m_maxPageSize.width() > 0 && page.width() > 0.){
+        maxZoom = std::max(1., m_maxPageSize.width()/(page.width()/m_zoom*devicePixelRatioF()));
+    }
+    qreal zoom = qBound(1., m_zoom*std::pow(zoomStep, ev->angleDelta().y()/120.), maxZoom);
+    if(qFuzzyCompare(zoom, m_zoom)){
+        return;
+    }
+
+    // the page position under the cursor stays under it
+    QPointF cursor = ev->posF();
+    QPointF pagePos((cursor.x() - page.x())/page.width(), (cursor.y() - page.y())/page.height());
+    QSizeF size = page.size()/m_zoom*zoom;
+    m_zoomCenter = QPointF(pagePos.x() - (cursor.x() - width()*0.5)/size.width(), pagePos.y() - (cursor.y() - height()*0.5)/size.height());
+    m_zoom = zoom;
+    clamp_zoom_center();
+    update();
+}
+
+void PreviewW::resizeEvent(QResizeEvent *ev){
+
+    PhotoW::resizeEvent(ev);
+    m_resizeTimer.start(200);
+}
+
 void PreviewW::paintEvent(QPaintEvent *event){
 
-    PhotoW::paintEvent(event);
+    QWidget::paintEvent(event);
+    if(m_image.isNull()){
+        return;
+    }
 
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // the preview has the size of the widget in device pixels, it is drawn without rescaling when not zoomed
+    clamp_zoom_center();
+    m_imageRect = page_rect();
+    painter.drawImage(m_imageRect, m_image);
+
+    // zoomed: the upscaled preview is covered by sharper tiles, the missing visible ones are asked to the worker
+    const qreal ratio = devicePixelRatioF();
+    const QSize pageSize = (m_imageRect.size()*ratio).toSize();
+    const QRectF visible = QRectF(rect()).intersected(m_imageRect).translated(-m_imageRect.topLeft());
+    if(m_previewPage != nullptr && m_zoom > 1. && pageSize.width() > m_image.width() && !visible.isEmpty()){
+
+        const int firstX = static_cast<int>(visible.left()*ratio)/tileSize;
+        const int firstY = static_cast<int>(visible.top()*ratio)/tileSize;
+        const int lastX  = std::max(0, static_cast<int>(std::ceil(visible.right()*ratio)) - 1)/tileSize;
+        const int lastY  = std::max(0, static_cast<int>(std::ceil(visible.bottom()*ratio)) - 1)/tileSize;
+
+        QVector<QRect> missingTiles;
+        QSet<QString> missingKeys;
+        for(int ty = firstY; ty <= lastY; ++ty){
+            for(int tx = firstX; tx <= lastX; ++tx){
+
+                QRect tile = QRect(tx*tileSize, ty*tileSize, tileSize, tileSize) & QRect(QPoint(0,0), pageSize);
+                if(tile.isEmpty()){
+                    continue;
+                }
+
+                QString key = tile_key(pageSize, tile.topLeft());
+                if(QImage *image = m_tiles.object(key)){
+                    painter.drawImage(QRectF(m_imageRect.topLeft() + QPointF(tile.topLeft())/ratio, QSizeF(tile.size())/ratio), *image);
+                }else{
+                    missingTiles.push_back(tile);
+                    missingKeys.insert(key);
+                }
+            }
+        }
+
+        // a new request replaces the previous one, it is only sent when the missing tiles change
+        if(missingKeys != m_requestedTiles){
+            m_requestedTiles = missingKeys;
+            if(missingTiles.size() > 0){
+                emit tiles_requested_signal(m_previewPage, pageSize, missingTiles);
+            }
+        }
+    }
+
+    painter.setPen(QPen(Qt::black, 1));
+    painter.drawRect(QRectF(m_imageRect.x()-1, m_imageRect.y(), m_imageRect.width()+1, m_imageRect.height()+1));
+
     if(m_rectRelative.width() > 0 && m_rectTimer.isActive() && m_currentRectId != -1){
 
         m_currentPCRect = QRectF(m_imageRect.x() + m_rectRelative.x()*m_imageRect.width(),
@@ -365,6 +365,16 @@ void RichTextEditW::init_with_another(const RichTextEditW &richTextEdit, std::sh
 }
 
 
+void RichTextEditW::clear_text(){
+
+    textEdit()->blockSignals(true);
+    textEdit()->clear();
+    textEdit()->blockSignals(false);
+    m_html       = std::make_shared<QString>(textEdit()->toHtml()); // the sets always draw a text
+    m_foreGround = qRgba(0,0,0,255);
+    m_backGround = qRgba(255,255,255,0);
+}
+
 void RichTextEditW::write_to_xml(QXmlStreamWriter &xml) const{
 
     xml.writeStartElement("RichText");
@@ -404,6 +414,28 @@ void RichTextEditW::load_from_xml(QXmlStreamReader &xml){
     }
 }
 
+std::shared_ptr<QString> RichTextEditW::read_html_from_xml(QXmlStreamReader &xml){
+
+    // the html was written from the editor, it is used as it is
+    std::shared_ptr<QString> html = nullptr;
+    QXmlStreamReader::TokenType token = QXmlStreamReader::TokenType::StartElement;
+    while(!xml.hasError()) {
+
+        if(token == QXmlStreamReader::TokenType::EndElement && xml.name() == "RichText"){
+            break;
+        }else if(token == QXmlStreamReader::TokenType::StartElement){
+
+            if(xml.name() == "xml"){
+                html = std::make_shared<QString>(xml.readElementText());
+            }
+        }
+
+        token = xml.readNext();
+    }
+
+    return html;
+}
+
 void RichTextEditW::setup_edit_actions()
 {
     m_menuLayoutCenter->setContentsMargins(0,0,0,0);
@@ -682,6 +714,8 @@ void RichTextEditW::setup_text_actions(){
     m_comboCodes->addItem("Numéro total de pages");
     m_comboCodes->addItem("Numéro total de photos");
     m_comboCodes->addItem("Nom de la page");
+    m_comboCodes->addItem("Heure de la photo");
+    m_comboCodes->addItem("Appareil photo");
     connect(m_comboCodes, QOverload<int>::of(&QComboBox::activated), this, [=](int index){
         m_comboCodes->clearFocus();
         textEdit()->setFocus();
@@ -711,6 +745,12 @@ void RichTextEditW::setup_text_actions(){
         case 7:
             code = "$nom_page$";
             break;
+        case 8:
+            code = "$heure_photo$";
+            break;
+        case 9:
+            code = "$appareil_photo$";
+            break;
         }
 
         textEdit()->textCursor().insertText(code);
@@ -87,9 +87,13 @@ PhotoAdjust Utility::photo_adjust_from_comboBox(QComboBox *cb){
 }
 
 qreal Utility::borders_line_width_from_comboBox(QComboBox *cb){
+    return borders_line_width_from_index(cb->currentIndex());
+}
+
+qreal Utility::borders_line_width_from_index(int index){
 
     qreal borderWidth = 1.;
-    switch(cb->currentIndex()){
+    switch(index){
         case 1:
             borderWidth = 3.;
         break;
@@ -116,9 +120,13 @@ qreal Utility::borders_line_width_from_comboBox(QComboBox *cb){
 }
 
 Qt::PenJoinStyle Utility::borders_join_style_from_comboBox(QComboBox *cb){
+    return borders_join_style_from_index(cb->currentIndex());
+}
+
+Qt::PenJoinStyle Utility::borders_join_style_from_index(int index){
 
     Qt::PenJoinStyle style = Qt::BevelJoin;
-    switch(cb->currentIndex()){
+    switch(index){
         case 1:
             style = Qt::MiterJoin;
         break;
@@ -131,10 +139,14 @@ Qt::PenJoinStyle Utility::borders_join_style_from_comboBox(QComboBox *cb){
 }
 
 void Utility::borders_line_style_from_comboBox(QComboBox *cb, QPen &pen){
+    borders_line_style_from_index(cb->currentIndex(), pen);
+}
+
+void Utility::borders_line_style_from_index(int index, QPen &pen){
 
     QVector<qreal> dashes;
     qreal space;
-    switch(cb->currentIndex()){
+    switch(index){
             case 0:
             pen.setStyle(Qt::SolidLine);
         break;
@@ -0,0 +1,332 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file DirectoryScannerWorker.cpp
+ * \brief defines DirectoryScannerWorker
+ * \date 19/10/2026
+ */
+
+// local
+#include "DirectoryScannerWorker.hpp"
+#include "Trace.hpp"
+
+// Qt
+#include <QCollator>
+#include <QElapsedTimer>
+#include <QImageReader>
+
+// std
+#include <algorithm>
+
+using namespace pc;
+
+namespace {
+
+    // a batch is sent when full or when the first path found waited too long
+    const int maxBatchSize  = 64;
+    const qint64 maxBatchWaitMs = 100;
+
+    // watch, the full rescan only catches what the notifications miss
+    const int checkDelayMs  = 500;
+    const int rescanDelayMs = 30000;
+
+    void natural_sort(QStringList &names){
+        QCollator collator;
+        collator.setNumericMode(true);
+        std::sort(names.begin(), names.end(), [&collator](const QString &name1, const QString &name2){
+            return collator.compare(name1, name2) < 0;
+        });
+    }
+}
+
+QSet<QString> DirectoryScannerWorker::supported_suffixes(){
+
+    QSet<QString> suffixes;
+    for(const auto &format : QImageReader::supportedImageFormats()){
+        suffixes.insert(QString::fromLatin1(format).toLower());
+    }
+    // vector and document formats readable by some image plugins are not photos
+    suffixes.remove("pdf");
+    suffixes.remove("svg");
+    suffixes.remove("svgz");
+    return suffixes;
+}
+
+DirectoryScannerWorker::DirectoryScannerWorker(){
+
+    m_supportedSuffixes = supported_suffixes();
+
+    m_watcher     = new QFileSystemWatcher(this);
+    m_checkTimer  = new QTimer(this);
+    m_rescanTimer = new QTimer(this);
+    m_checkTimer->setSingleShot(true);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [&](const QString &path){
+        m_changedDirectories.insert(path);
+        if(!m_checkTimer->isActive()){
+            m_checkTimer->start(checkDelayMs);
+        }
+    });
+    connect(m_checkTimer,  &QTimer::timeout, this, &DirectoryScannerWorker::check_changed_directories);
+    connect(m_rescanTimer, &QTimer::timeout, this, &DirectoryScannerWorker::check_watched_directory);
+}
+
+void DirectoryScannerWorker::cancel(){
+    m_cancel = true;
+}
+
+void DirectoryScannerWorker::scan_directory(QString directory, bool recursive){
+
+    TraceSpan span("scan_directory");
+
+    m_cancel = false;
+
+    int nbPhotosFound = 0;
+    QStringList batch;
+    QElapsedTimer batchTimer;
+
+    auto send_batch = [&]{
+        if(batch.size() > 0){
+            nbPhotosFound += batch.size();
+            emit photos_found_signal(batch);
+            batch.clear();
+        }
+    };
+
+    // depth first, each directory files before its sub-directories
+    QStringList directories = {directory};
+    while(directories.size() > 0 && !m_cancel){
+
+        QDir dir(directories.takeFirst());
+        for(const auto &path : photos_of(dir)){
+
+            if(m_cancel){
+                break;
+            }
+
+            if(batch.size() == 0){
+                batchTimer.start();
+            }
+            batch << path;
+            m_sentFiles[path] = state_of(path);
+
+            if(batch.size() >= maxBatchSize || batchTimer.elapsed() > maxBatchWaitMs){
+                send_batch();
+            }
+        }
+
+        // the files of a directory are sent before listing the next one
+        send_batch();
+
+        if(recursive){
+            QStringList subDirectories = sub_directories_of(dir);
+            for(int ii = subDirectories.size()-1; ii >= 0; --ii){
+                directories.push_front(subDirectories[ii]);
+            }
+        }
+    }
+
+    if(!m_cancel){
+        send_batch();
+    }
+
+    emit end_scanning_signal(nbPhotosFound, m_cancel);
+}
+
+void DirectoryScannerWorker::watch_directory(QString directory, bool recursive){
+
+    stop_watching();
+
+    m_watchedDirectory = directory;
+    m_watchRecursive   = recursive;
+    m_rescanTimer->start(rescanDelayMs);
+    check_watched_directory();
+}
+
+void DirectoryScannerWorker::stop_watching(){
+
+    if(m_watchedDirectories.size() > 0){
+        m_watcher->removePaths(m_watchedDirectories.toList());
+    }
+    m_checkTimer->stop();
+    m_rescanTimer->stop();
+    m_watchedDirectory.clear();
+    m_watchedDirectories.clear();
+    m_changedDirectories.clear();
+    m_pendingFiles.clear();
+}
+
+void DirectoryScannerWorker::check_watched_directory(){
+
+    if(m_watchedDirectory.size() == 0){
+        return;
+    }
+
+    TraceSpan span("check_watched_directory");
+
+    m_changedDirectories.clear();
+    check_directories({m_watchedDirectory}, true);
+}
+
+void DirectoryScannerWorker::check_changed_directories(){
+
+    if(m_watchedDirectory.size() == 0){
+        return;
+    }
+
+    TraceSpan span("check_changed_directories");
+
+    // the notified directories and the ones with files not stable yet
+    QSet<QString> directories = m_changedDirectories;
+    m_changedDirectories.clear();
+    for(auto it = m_pendingFiles.constBegin(); it != m_pendingFiles.constEnd(); ++it){
+        directories.insert(QFileInfo(it.key()).absolutePath());
+    }
+    check_directories(directories.toList(), false);
+}
+
+void DirectoryScannerWorker::check_directories(QStringList directories, bool recursive){
+
+    QStringList newPhotos, modifiedPhotos;
+    QSet<QString> visited, listed;
+
+    while(directories.size() > 0){
+
+        QDir dir(directories.takeFirst());
+        const QString dirPath = dir.absolutePath();
+        if(visited.contains(dirPath)){
+            continue;
+        }
+        visited.insert(dirPath);
+
+        if(!dir.exists()){
+            if(m_watchedDirectories.remove(dirPath)){
+                m_watcher->removePath(dirPath);
+            }
+            continue;
+        }
+
+        // sub-directories created later are watched too
+        if(!m_watchedDirectories.contains(dirPath)){
+            m_watchedDirectories.insert(dirPath);
+            m_watcher->addPath(dirPath);
+        }
+
+        for(const auto &path : photos_of(dir)){
+
+            listed.insert(path);
+
+            FileState state = state_of(path);
+            auto sent = m_sentFiles.find(path);
+            if(sent != m_sentFiles.end() && sent.value() == state){
+                m_pendingFiles.remove(path);
+                continue;
+            }
+
+            // a file still being copied changes between two checks
+            auto pending = m_pendingFiles.find(path);
+            if(pending == m_pendingFiles.end() || !(pending.value() == state) || state.size == 0){
+                m_pendingFiles[path] = state;
+                continue;
+            }
+
+            m_pendingFiles.erase(pending);
+            if(sent != m_sentFiles.end()){
+                modifiedPhotos << path;
+            }else{
+                newPhotos << path;
+            }
+            m_sentFiles[path] = state;
+        }
+
+        // a partial check only goes down in the sub-directories not watched yet
+        if(m_watchRecursive){
+            for(const auto &subDirectory : sub_directories_of(dir)){
+                if(recursive || !m_watchedDirectories.contains(QDir(subDirectory).absolutePath())){
+                    directories.append(subDirectory);
+                }
+            }
+        }
+    }
+
+    // files of the checked directories removed since, before being stable or after being sent
+    auto removed = [&](const QString &path){
+        return !listed.contains(path) && visited.contains(QFileInfo(path).absolutePath());
+    };
+    for(auto it = m_pendingFiles.begin(); it != m_pendingFiles.end();){
+        it = removed(it.key()) ? m_pendingFiles.erase(it) : ++it;
+    }
+    for(auto it = m_sentFiles.begin(); it != m_sentFiles.end();){
+        it = removed(it.key()) ? m_sentFiles.erase(it) : ++it;
+    }
+
+    if(m_pendingFiles.size() > 0){
+        m_checkTimer->start(checkDelayMs);
+    }
+
+    if(newPhotos.size() > 0){
+        for(int ii = 0; ii < newPhotos.size(); ii += maxBatchSize){
+            emit photos_found_signal(newPhotos.mid(ii, maxBatchSize));
+        }
+        emit end_scanning_signal(newPhotos.size(), false);
+    }
+
+    if(modifiedPhotos.size() > 0){
+        emit photos_modified_signal(modifiedPhotos);
+    }
+}
+
+QStringList DirectoryScannerWorker::photos_of(const QDir &dir) const{
+
+    QStringList photos;
+    QStringList files = dir.entryList(QDir::Files | QDir::Readable);
+    natural_sort(files);
+    for(const auto &file : files){
+        if(m_supportedSuffixes.contains(QFileInfo(file).suffix().toLower())){
+            photos << dir.filePath(file);
+        }
+    }
+    return photos;
+}
+
+QStringList DirectoryScannerWorker::sub_directories_of(const QDir &dir){
+
+    // symbolic links are not followed to avoid cycles
+    QStringList subDirectories = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks | QDir::Readable);
+    natural_sort(subDirectories);
+    for(auto &&subDirectory : subDirectories){
+        subDirectory = dir.filePath(subDirectory);
+    }
+    return subDirectories;
+}
+
+DirectoryScannerWorker::FileState DirectoryScannerWorker::state_of(const QString &path){
+    QFileInfo info(path);
+    return {info.size(), info.lastModified()};
+}
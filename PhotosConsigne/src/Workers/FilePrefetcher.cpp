@@ -0,0 +1,194 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+
+/**
+ * \file FilePrefetcher.cpp
+ * \brief defines FilePrefetcher
+ * \date 19/10/2026
+ */
+
+// local
+#include "FilePrefetcher.hpp"
+#include "Counters.hpp"
+#include "Trace.hpp"
+
+// Qt
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtConcurrent>
+
+// std
+#include <algorithm>
+#include <limits>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+using namespace pc;
+
+FilePrefetcher::FilePrefetcher(qint64 maxBytes, int nbReaders) : m_maxBytes(maxBytes), m_nbReaders(nbReaders){
+    m_readers.setMaxThreadCount(nbReaders);
+}
+
+FilePrefetcher::~FilePrefetcher(){
+    clear();
+    m_readers.waitForDone();
+}
+
+void FilePrefetcher::prefetch(const QStringList &paths){
+
+    QMutexLocker locker(&m_locker);
+
+    // release the buffers not needed anymore
+    QSet<QString> upcoming = paths.toSet();
+    for(auto it = m_ready.begin(); it != m_ready.end();){
+        if(!upcoming.contains(it.key())){
+            m_bytesHeld -= it.value().size();
+            it = m_ready.erase(it);
+        }else{
+            ++it;
+        }
+    }
+
+    m_pending.clear();
+    for(const auto &path : paths){
+        if(!m_ready.contains(path) && !m_reading.contains(path)){
+            m_pending.push_back(path);
+        }
+    }
+
+    schedule_reads();
+}
+
+QByteArray FilePrefetcher::take(const QString &path){
+
+    QMutexLocker locker(&m_locker);
+    m_pending.removeAll(path);
+
+    if(m_reading.contains(path)){
+        QElapsedTimer timer;
+        timer.start();
+        while(m_reading.contains(path)){
+            m_readDone.wait(&m_locker);
+        }
+        Counters::add(Counter::PrefetchWaitUs, timer.nsecsElapsed()/1000);
+    }
+
+    auto buffer = m_ready.find(path);
+    if(buffer != m_ready.end()){
+        QByteArray data = buffer.value();
+        m_bytesHeld -= data.size();
+        m_ready.erase(buffer);
+        Counters::add(Counter::PrefetchHits);
+        schedule_reads();
+        return data;
+    }
+
+    locker.unlock();
+    Counters::add(Counter::PrefetchMisses);
+    return read_file(path);
+}
+
+void FilePrefetcher::clear(){
+
+    QMutexLocker locker(&m_locker);
+    m_pending.clear();
+    m_ready.clear();
+    m_bytesHeld = 0;
+    Counters::set(Counter::PrefetchBytes, 0);
+}
+
+void FilePrefetcher::schedule_reads(){
+
+    // called with the lock held, the budget is checked before each read, a file can exceed it
+    while(m_pending.size() > 0 && m_reading.size() < m_nbReaders && m_bytesHeld < m_maxBytes){
+
+        QString path = m_pending.takeFirst();
+        m_reading.insert(path);
+
+        QtConcurrent::run(&m_readers, [this, path]{
+
+            QByteArray data = read_file(path);
+
+            QMutexLocker locker(&m_locker);
+            m_reading.remove(path);
+            m_ready[path] = data;
+            m_bytesHeld += data.size();
+            Counters::set(Counter::PrefetchBytes, m_bytesHeld);
+            m_readDone.wakeAll();
+            schedule_reads();
+        });
+    }
+    Counters::set(Counter::PrefetchBytes, m_bytesHeld);
+}
+
+QByteArray FilePrefetcher::read_file(const QString &path){
+
+    TraceSpan span("read_file");
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        qWarning() << "-Error: can't read file: " << path;
+        return QByteArray();
+    }
+
+#ifdef Q_OS_LINUX
+    // the whole file is needed, let the kernel read ahead aggressively
+    posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    QByteArray data;
+    data.resize(static_cast<int>(std::min<qint64>(file.size(), std::numeric_limits<int>::max())));
+    qint64 offset = 0;
+    const qint64 chunkSize = 4*1024*1024;
+    while(offset < data.size()){
+        qint64 read = file.read(data.data() + offset, std::min<qint64>(chunkSize, data.size() - offset));
+        if(read <= 0){
+            break;
+        }
+        offset += read;
+    }
+    data.resize(static_cast<int>(offset));
+    return data;
+}
+
+bool FilePrefetcher::evict_from_cache(const QString &path){
+
+#ifdef Q_OS_LINUX
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+    return posix_fadvise(file.handle(), 0, 0, POSIX_FADV_DONTNEED) == 0;
+#else
+    Q_UNUSED(path);
+    return false;
+#endif
+}
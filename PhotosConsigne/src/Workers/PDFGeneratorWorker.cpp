@@ -33,14 +33,129 @@
 
 // local
 #include "PDFGeneratorWorker.hpp"
+#include "Trace.hpp"
+#include "PdfMerger.hpp"
 
 // Qt
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QThread>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QEventLoop>
 #include <QVector2D>
+#include <QTimer>
+#include <QtConcurrent>
+
+// std
+#include <algorithm>
 
 
 using namespace pc;
 
+namespace{
+
+    /**
+     * @brief Text document reading the images added to its parent document
+     */
+    class ChildTextDocument : public QTextDocument{
+
+    public:
+
+        ChildTextDocument(QTextDocument *parent) : QTextDocument(parent), m_parent(parent){}
+
+    protected:
+
+        QVariant loadResource(int type, const QUrl &name) override{
+
+            // resources added with addResource are not looked up by the parent loadResource
+            QVariant resource = m_parent->resource(type, name);
+            if(resource.isValid()){
+                return resource;
+            }
+            return QTextDocument::loadResource(type, name);
+        }
+
+    private:
+
+        QTextDocument *m_parent = nullptr;
+    };
+
+    struct SetJob{
+        SPCSet set;
+        ExtraPCInfo infos;
+    };
+
+    struct PreparedSet{
+        QString html;
+        PreparedPhoto photo;
+    };
+
+    /**
+     * @brief Format the text and scale the photo of a set, independent from the other sets
+     */
+    PreparedSet prepare_set(const SetJob &job){
+
+        PreparedSet prepared;
+        ExtraPCInfo infos = job.infos;
+        const SPCSet &pcSet = job.set;
+        if(pcSet->text->rectOnPage.width()> 0 && pcSet->text->rectOnPage.height()>0){
+            infos.factorUpscale = 1.; // text is formatted at the reference scale, see draw_html
+            prepared.html = Drawing::format_html_for_generation(*pcSet->settings->text.html, infos);
+        }
+        if(pcSet->photo != nullptr && pcSet->photoRect.width() > 0 && pcSet->photoRect.height() > 0){
+            prepared.photo = pcSet->photo->prepare_preview(pcSet->settings->style.imagePosition, pcSet->photoRect, job.infos);
+        }
+        return prepared;
+    }
+
+    /**
+     * @brief Take from the tiles the first rectangular run in reading order: the touching tiles of its row,
+     *  extended with the next rows while they cover exactly the same columns
+     * @return tiles of the run, their union is the run rectangle
+     */
+    QVector<QRect> take_tiles_run(QVector<QRect> &tiles, QRect &run){
+
+        std::sort(tiles.begin(), tiles.end(), [](const QRect &r1, const QRect &r2){
+            return r1.top() != r2.top() ? r1.top() < r2.top() : r1.left() < r2.left();
+        });
+
+        QVector<QRect> runTiles;
+        run = tiles.takeFirst();
+        runTiles << run;
+
+        // tiles are sorted, the touching tiles of the row follow each other
+        while(tiles.size() > 0 && tiles[0].top() == run.top() && tiles[0].bottom() == run.bottom() && tiles[0].left() == run.right()+1){
+            run |= tiles[0];
+            runTiles << tiles.takeFirst();
+        }
+
+        while(true){
+
+            QVector<int> rowIds;
+            int nextLeft = run.left();
+            for(int ii = 0; ii < tiles.size(); ++ii){
+                if(tiles[ii].top() == run.bottom()+1 && tiles[ii].left() == nextLeft && tiles[ii].right() <= run.right()){
+                    if(rowIds.size() > 0 && tiles[ii].bottom() != tiles[rowIds[0]].bottom()){
+                        break;
+                    }
+                    rowIds << ii;
+                    nextLeft = tiles[ii].right()+1;
+                }
+            }
+
+            if(rowIds.size() == 0 || nextLeft != run.right()+1){
+                return runTiles;
+            }
+
+            for(int ii = rowIds.size()-1; ii >= 0; --ii){
+                run |= tiles[rowIds[ii]];
+                runTiles << tiles.takeAt(rowIds[ii]);
+            }
+        }
+    }
+}
+
 
 void PDFGeneratorWorker::draw_zones(QPainter &painter, SPCPage pcPage){
 
@@ -74,7 +189,7 @@ void PDFGeneratorWorker::draw_zones(QPainter &painter, SPCPage pcPage){
         Drawing::draw_filled_rect(painter, set->rectOnPage, qRgb(255,255,255), 0.3);
 
         // photo
-        Drawing::draw_filled_rect(painter, set->photo->rectOnPage, qRgb(255,255,0), 0.3);
+        Drawing::draw_filled_rect(painter, set->photoRect, qRgb(255,255,0), 0.3);
 
         // text
         Drawing::draw_filled_rect(painter, set->text->rectOnPage, qRgb(0,0,200), 0.3);
@@ -157,12 +272,80 @@ void PDFGeneratorWorker::draw_degraded(QPainter &painter, const QRectF &rectPage
 
 void PDFGeneratorWorker::draw_backgrounds(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos){
 
+    // zoomed preview tiles are small clipped parts of a large page, a layer of the whole page is not cached for them
+    if(painter.hasClipping()){
+        painter.save();
+        painter.setPen(Qt::NoPen);
+        compose_backgrounds(painter, pcPage, infos);
+        painter.restore();
+        return;
+    }
+
+    BackgroundLayer key;
+    key.page            = pcPage->settings->background;
+    key.header          = pcPage->header->settings->background;
+    key.footer          = pcPage->footer->settings->background;
+    key.headerEnabled   = pcPage->header->settings->enabled;
+    key.footerEnabled   = pcPage->footer->settings->enabled;
+    key.pageRect        = pcPage->rectOnPage;
+    key.headerRect      = pcPage->header->rectOnPage;
+    key.footerRect      = pcPage->footer->rectOnPage;
+    key.preview         = infos.preview;
+    key.factorUpscale   = infos.factorUpscale;
+
+    const BackGroundSettings *backgrounds[3] = {&key.page, &key.header, &key.footer};
+    for(int ii = 0; ii < 3; ++ii){
+        if(backgrounds[ii]->displayPhoto && backgrounds[ii]->photo != nullptr){
+            key.photosKey[ii]      = backgrounds[ii]->photo->scaledPhoto.cacheKey();
+            key.photosRotation[ii] = backgrounds[ii]->photo->rotation;
+        }
+    }
+
+    auto layer = std::find_if(m_backgroundLayers.begin(), m_backgroundLayers.end(), [&](const BackgroundLayer &cached){
+        return cached.same_key(key);
+    });
+    Counters::hit(Counter::BackgroundLayersHits, Counter::BackgroundLayersMisses, layer != m_backgroundLayers.end());
+
+    if(layer != m_backgroundLayers.end()){
+        m_backgroundLayers.move(static_cast<int>(std::distance(m_backgroundLayers.begin(), layer)), 0);
+    }else{
+
+        // compose the layer with the painting settings of the target
+        QPainter layerPainter;
+        if(key.preview){
+            key.image = QImage(static_cast<int>(key.pageRect.width()), static_cast<int>(key.pageRect.height()), QImage::Format_RGB32);
+            layerPainter.begin(&key.image);
+            layerPainter.translate(-key.pageRect.topLeft());
+        }else{
+            layerPainter.begin(&key.picture);
+        }
+        layerPainter.setRenderHints(painter.renderHints());
+        layerPainter.setPen(Qt::NoPen);
+        compose_backgrounds(layerPainter, pcPage, infos);
+        layerPainter.end();
+
+        m_backgroundLayers.push_front(std::move(key));
+        while(m_backgroundLayers.size() > maxBackgroundLayers){
+            m_backgroundLayers.removeLast();
+        }
+    }
+
+    const BackgroundLayer &cached = m_backgroundLayers.first();
+    if(cached.preview){
+        painter.drawImage(cached.pageRect.topLeft(), cached.image);
+    }else{
+        painter.drawPicture(0, 0, cached.picture);
+    }
+}
+
+void PDFGeneratorWorker::compose_backgrounds(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos){
+
     // page background
     // # color
     QBrush brush;
     brush.setStyle(Qt::SolidPattern);
 
-    BackGroundSettings &background = pcPage->settings.background;
+    const BackGroundSettings &background = pcPage->settings->background;
 
     // # white background
     brush.setStyle(Qt::SolidPattern);
@@ -170,10 +353,10 @@ void PDFGeneratorWorker::draw_backgrounds(QPainter &painter, SPCPage pcPage, Ext
     painter.fillRect(pcPage->rectOnPage,brush);
 
     // # photo
-    if(pcPage->settings.background.displayPhoto){
+    if(pcPage->settings->background.displayPhoto){
 
         if(background.photo != nullptr){
-            background.photo->draw(painter, pcPage->settings.background.imagePosition, pcPage->rectOnPage, infos, pcPage->rectOnPage.size());
+            background.photo->draw(painter, pcPage->settings->background.imagePosition, pcPage->rectOnPage, infos, pcPage->rectOnPage.size());
         }
     }
 
@@ -189,48 +372,48 @@ void PDFGeneratorWorker::draw_backgrounds(QPainter &painter, SPCPage pcPage, Ext
     }
 
     // header background
-    if(pcPage->header->settings.enabled){
+    if(pcPage->header->settings->enabled){
 
         // # color
         brush.setStyle(Qt::SolidPattern);
-        if(pcPage->header->settings.background.colors.type == ColorType::color1){
-            brush.setColor(pcPage->header->settings.background.colors.color1);
+        if(pcPage->header->settings->background.colors.type == ColorType::color1){
+            brush.setColor(pcPage->header->settings->background.colors.color1);
             painter.fillRect(pcPage->header->rectOnPage,brush);
-        }else if(pcPage->header->settings.background.colors.type == ColorType::color2){
-            brush.setColor(pcPage->header->settings.background.colors.color2);
+        }else if(pcPage->header->settings->background.colors.type == ColorType::color2){
+            brush.setColor(pcPage->header->settings->background.colors.color2);
             painter.fillRect(pcPage->header->rectOnPage,brush);
         }else{
-            draw_degraded(painter, pcPage->header->rectOnPage, pcPage->header->settings.background.colors, infos);
+            draw_degraded(painter, pcPage->header->rectOnPage, pcPage->header->settings->background.colors, infos);
         }
 
         // # photo
-        if(pcPage->header->settings.background.displayPhoto){
-            if(pcPage->header->settings.background.photo != nullptr){
-                pcPage->header->settings.background.photo->draw(painter, pcPage->header->settings.background.imagePosition, pcPage->header->rectOnPage, infos, pcPage->header->rectOnPage.size());
+        if(pcPage->header->settings->background.displayPhoto){
+            if(pcPage->header->settings->background.photo != nullptr){
+                pcPage->header->settings->background.photo->draw(painter, pcPage->header->settings->background.imagePosition, pcPage->header->rectOnPage, infos, pcPage->header->rectOnPage.size());
             }
         }
     }
 
     // footer background
-    if(pcPage->footer->settings.enabled){
+    if(pcPage->footer->settings->enabled){
 
         // # color
         brush.setStyle(Qt::SolidPattern);
-        if(pcPage->footer->settings.background.colors.type == ColorType::color1){
-            brush.setColor(pcPage->footer->settings.background.colors.color1);
+        if(pcPage->footer->settings->background.colors.type == ColorType::color1){
+            brush.setColor(pcPage->footer->settings->background.colors.color1);
             painter.fillRect(pcPage->footer->rectOnPage,brush);
-        }else if(pcPage->footer->settings.background.colors.type == ColorType::color2){
-            brush.setColor(pcPage->footer->settings.background.colors.color2);
+        }else if(pcPage->footer->settings->background.colors.type == ColorType::color2){
+            brush.setColor(pcPage->footer->settings->background.colors.color2);
             painter.fillRect(pcPage->footer->rectOnPage,brush);
         }else{
-            draw_degraded(painter, pcPage->footer->rectOnPage, pcPage->footer->settings.background.colors, infos);
+            draw_degraded(painter, pcPage->footer->rectOnPage, pcPage->footer->settings->background.colors, infos);
         }
 
         // # photo
-        if(pcPage->footer->settings.background.displayPhoto){
+        if(pcPage->footer->settings->background.displayPhoto){
 
-            if(pcPage->footer->settings.background.photo != nullptr){
-                pcPage->footer->settings.background.photo->draw(painter,  pcPage->footer->settings.background.imagePosition, pcPage->footer->rectOnPage, infos, pcPage->footer->rectOnPage.size());
+            if(pcPage->footer->settings->background.photo != nullptr){
+                pcPage->footer->settings->background.photo->draw(painter,  pcPage->footer->settings->background.imagePosition, pcPage->footer->rectOnPage, infos, pcPage->footer->rectOnPage.size());
             }
         }
     }
@@ -238,65 +421,118 @@ void PDFGeneratorWorker::draw_backgrounds(QPainter &painter, SPCPage pcPage, Ext
 
 void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraPCInfo &infos){
 
+    auto set_infos = [](ExtraPCInfo &setInfos, const SPCSet &pcSet){
+        setInfos.photoNum   = pcSet->totalId;
+        setInfos.photoPCNum = pcSet->id;
+        setInfos.namePCAssociatedPhoto = pcSet->photo->namePhoto;
+        setInfos.fileDate = pcSet->photo->lastModified;
+        setInfos.photoMetadata = pcSet->photo->metadata;
+    };
+
+    // zoomed preview tiles: the sets outside the clip are neither prepared nor drawn
+    const QRectF clip = painter.hasClipping() ? painter.clipBoundingRect() : QRectF();
+    auto is_visible = [&](const SPCSet &pcSet){
+        if(clip.isNull()){
+            return true;
+        }
+        const qreal margin = pcSet->settings->borders.width*infos.factorUpscale + 1.;
+        return clip.intersects(pcSet->rectOnPage.adjusted(-margin, -margin, margin, margin));
+    };
+
+    // preview: texts formatting and photos scaling of the sets are computed in parallel,
+    // the sets are then drawn in order with the same operations as the serial path
+    QVector<PreparedSet> prepared;
+    if(infos.preview && pcPage->sets.size() > 1){
+        QVector<SetJob> jobs;
+        QVector<int> jobsSetId;
+        jobs.reserve(pcPage->sets.size());
+        for(int idSet = 0; idSet < pcPage->sets.size(); ++idSet){
+            const SPCSet &pcSet = pcPage->sets[idSet];
+            if(!is_visible(pcSet)){
+                continue;
+            }
+            jobs.push_back({pcSet, infos});
+            jobsSetId.push_back(idSet);
+            set_infos(jobs.last().infos, pcSet);
+        }
+        TraceSpan span("prepare_sets");
+        QVector<PreparedSet> preparedJobs = QtConcurrent::blockingMapped<QVector<PreparedSet>>(jobs, &prepare_set);
+        prepared.resize(pcPage->sets.size());
+        for(int ii = 0; ii < jobsSetId.size(); ++ii){
+            prepared[jobsSetId[ii]] = std::move(preparedJobs[ii]);
+        }
+    }
+
     // PC
-    for(auto &&set : pcPage->sets){
+    for(int idSet = 0; idSet < pcPage->sets.size(); ++idSet){
 
         painter.setOpacity(1.);
-        SPCSet pcSet = set;
-        infos.photoNum   = pcSet->totalId;
-        infos.photoPCNum = pcSet->id;
-        infos.namePCAssociatedPhoto = pcSet->photo->namePhoto;
-        infos.fileInfo = pcSet->photo->info;
+        SPCSet pcSet = pcPage->sets[idSet];
+        if(!is_visible(pcSet)){
+            continue;
+        }
+        set_infos(infos, pcSet);
+        const bool isPrepared = prepared.size() > 0;
 
         if(!infos.preview){
             emit set_progress_bar_text_signal("Dessin photo-consigne n°" + QString::number(pcSet->totalId));
-            QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
         }
 
-        if(pcSet->settings.style.textPositionFromPhotos != Position::on){
+        if(pcSet->settings->style.textPositionFromPhotos != Position::on){
 
             // draw text
             if(pcSet->text->rectOnPage.width()> 0 && pcSet->text->rectOnPage.height()>0){ // ############################ costly
 
-                draw_html(painter, Drawing::format_html_for_generation(*pcSet->settings.text.html, infos),
-                          QRectF(pcSet->rectOnPage.x(),pcSet->rectOnPage.y(),pcSet->text->rectOnPage.width(), pcPage->rectOnPage.height()),
-                          pcSet->text->rectOnPage);
+                QRectF upperRect(pcSet->rectOnPage.x(),pcSet->rectOnPage.y(),pcSet->text->rectOnPage.width(), pcPage->rectOnPage.height());
+                if(isPrepared){
+                    draw_formatted_html(painter, prepared[idSet].html, infos.factorUpscale, upperRect, pcSet->text->rectOnPage);
+                }else{
+                    draw_html(painter, *pcSet->settings->text.html, infos, upperRect, pcSet->text->rectOnPage);
+                }
             }
         }
 
         // draw photo
         if(pcSet->photo != nullptr){
-            if(pcSet->photo->rectOnPage.width() > 0 && pcSet->photo->rectOnPage.height() > 0){ // ############################ costly
-                pcSet->photo->draw(painter,pcSet->settings.style.imagePosition ,pcSet->photo->rectOnPage, infos, pcPage->rectOnPage.size());
+            if(pcSet->photoRect.width() > 0 && pcSet->photoRect.height() > 0){ // ############################ costly
+                if(isPrepared){
+                    pcSet->photo->draw_prepared(painter, prepared[idSet].photo, infos, pcPage->rectOnPage.size());
+                }else{
+                    pcSet->photo->draw(painter,pcSet->settings->style.imagePosition ,pcSet->photoRect, infos, pcPage->rectOnPage.size());
+                }
             }
         }
 
-        if(pcSet->settings.style.textPositionFromPhotos == Position::on){
+        if(pcSet->settings->style.textPositionFromPhotos == Position::on){
             // draw text
             if(pcSet->text->rectOnPage.width()> 0 && pcSet->text->rectOnPage.height()>0){ // ############################ costly
 
-                draw_html(painter, Drawing::format_html_for_generation(*pcSet->settings.text.html, infos),
-                          QRectF(pcSet->rectOnPage.x(),pcSet->rectOnPage.y(),pcSet->text->rectOnPage.width(), pcPage->rectOnPage.height()),
-                          pcSet->text->rectOnPage);
+                QRectF upperRect(pcSet->rectOnPage.x(),pcSet->rectOnPage.y(),pcSet->text->rectOnPage.width(), pcPage->rectOnPage.height());
+                if(isPrepared){
+                    draw_formatted_html(painter, prepared[idSet].html, infos.factorUpscale, upperRect, pcSet->text->rectOnPage);
+                }else{
+                    draw_html(painter, *pcSet->settings->text.html, infos, upperRect, pcSet->text->rectOnPage);
+                }
             }
         }
 
 
-        BordersSettings &borders = pcSet->settings.borders;
+        const BordersSettings &borders = pcSet->settings->borders;
         if(borders.display){
-            borders.pen.setWidthF(borders.width*infos.factorUpscale);
+            QPen pen = borders.pen; // settings are shared between the sets
+            pen.setWidthF(borders.width*infos.factorUpscale);
             painter.setOpacity(1.);
-            painter.setPen(borders.pen);
+            painter.setPen(pen);
 
             if(borders.between){
 
-                if(pcSet->settings.style.textPositionFromPhotos == Position::top){
+                if(pcSet->settings->style.textPositionFromPhotos == Position::top){
                     painter.drawLine(pcSet->text->rectOnPage.bottomLeft(), pcSet->text->rectOnPage.bottomRight());
-                }else if(pcSet->settings.style.textPositionFromPhotos == Position::bottom){
+                }else if(pcSet->settings->style.textPositionFromPhotos == Position::bottom){
                     painter.drawLine(pcSet->text->rectOnPage.topLeft(), pcSet->text->rectOnPage.topRight());
-                }else if(pcSet->settings.style.textPositionFromPhotos == Position::left){
+                }else if(pcSet->settings->style.textPositionFromPhotos == Position::left){
                     painter.drawLine(pcSet->text->rectOnPage.bottomRight(), pcSet->text->rectOnPage.topRight());
-                }else if(pcSet->settings.style.textPositionFromPhotos == Position::right){
+                }else if(pcSet->settings->style.textPositionFromPhotos == Position::right){
                     painter.drawLine(pcSet->text->rectOnPage.bottomLeft(), pcSet->text->rectOnPage.topLeft());
                 }
             }
@@ -358,12 +594,11 @@ void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraP
 
         if(!infos.preview){
             emit set_progress_bar_state_signal(static_cast<int>(1000. * pcSet->totalId/m_totalPC));
-            QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
         }
     }
 
     // header
-    if(pcPage->header->settings.enabled && !pcPage->settings.misc.doNotDisplayHeader){
+    if(pcPage->header->settings->enabled && !pcPage->settings->misc.doNotDisplayHeader){
 
         // text
         if(pcPage->header->rectOnPage.height() > 0){
@@ -373,10 +608,9 @@ void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraP
 
             if(!infos.preview){
                 emit set_progress_bar_text_signal("Dessin haut de page");
-                QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
             }
 
-            draw_html(painter, Drawing::format_html_for_generation(*pcPage->header->settings.text.html.get(), infos),
+            draw_html(painter, *pcPage->header->settings->text.html, infos,
                       QRectF(pcPage->header->rectOnPage.x(),        pcPage->header->rectOnPage.y(),
                              pcPage->header->rectOnPage.width(),    pcPage->rectOnPage.height()),
                       pcPage->header->rectOnPage);
@@ -384,7 +618,7 @@ void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraP
     }
 
     // footer
-    if(pcPage->footer->settings.enabled && !pcPage->settings.misc.doNotDisplayFooter){
+    if(pcPage->footer->settings->enabled && !pcPage->settings->misc.doNotDisplayFooter){
 
         // text
         if(pcPage->footer->rectOnPage.height() > 0){
@@ -395,10 +629,9 @@ void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraP
 
             if(!infos.preview){
                 emit set_progress_bar_text_signal("Dessin base de page");
-                QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
             }
 
-            draw_html(painter, Drawing::format_html_for_generation(*pcPage->footer->settings.text.html.get(), infos),
+            draw_html(painter, *pcPage->footer->settings->text.html, infos,
                       QRectF(pcPage->footer->rectOnPage.x(),        pcPage->footer->rectOnPage.y(),
                              pcPage->footer->rectOnPage.width(),    pcPage->rectOnPage.height()),
                       pcPage->footer->rectOnPage);
@@ -407,9 +640,9 @@ void PDFGeneratorWorker::draw_contents(QPainter &painter, SPCPage pcPage, ExtraP
 }
 
 
-void PDFGeneratorWorker::draw_page(QPainter &painter, pc::PCPages &pcPages, const int idPageToDraw, const qreal factorUpscale, const bool preview, const bool drawZones){
+void PDFGeneratorWorker::draw_page(QPainter &painter, const PCPages &pcPages, SPCPage pcPage, const int idPageToDraw, const qreal factorUpscale, const bool preview, const bool drawZones){
 
-    SPCPage pcPage = pcPages.pages[idPageToDraw];
+    TraceSpan span("draw_page");
 
     ExtraPCInfo infos;
     infos.pagesNb       = pcPages.pages.size();
@@ -420,7 +653,7 @@ void PDFGeneratorWorker::draw_page(QPainter &painter, pc::PCPages &pcPages, cons
     infos.paperFormat   = pcPages.settings.paperFormat;
     infos.factorUpscale = factorUpscale;
     infos.displaySizes  = drawZones;
-    infos.pageName      = pcPage->settings.name;
+    infos.pageName      = pcPage->settings->name;
 
     for(auto &&page : pcPages.pages){
         infos.photoTotalNum += page->sets.size();
@@ -453,19 +686,56 @@ void PDFGeneratorWorker::draw_page(QPainter &painter, pc::PCPages &pcPages, cons
     }
 }
 
-void PDFGeneratorWorker::draw_html(QPainter &painter, QString html, QRectF upperRect, QRectF docRect){
+void PDFGeneratorWorker::draw_html(QPainter &painter, const QString &html, ExtraPCInfo infos, QRectF upperRect, QRectF docRect){
+
+    TraceSpan span("draw_html");
 
     if(static_cast<int>(upperRect.width()) == 0 || static_cast<int>(upperRect.height()) == 0){
         return;
     }
 
-    m_doc->setPageSize(QSizeF(upperRect.width(), upperRect.height()));
-    m_doc->setHtml(std::move(html));
+    // the text is formatted and laid out at the reference scale, then scaled by the painter
+    const qreal factor = infos.factorUpscale;
+    infos.factorUpscale = 1.;
+    draw_formatted_html(painter, Drawing::format_html_for_generation(html, infos), factor, upperRect, docRect);
+}
+
+void PDFGeneratorWorker::draw_formatted_html(QPainter &painter, const QString &html, qreal factor, QRectF upperRect, QRectF docRect){
+
+    if(static_cast<int>(upperRect.width()) == 0 || static_cast<int>(upperRect.height()) == 0){
+        return;
+    }
+
+    QTextDocument *doc = text_layout(html, upperRect.size()/factor);
+
+    painter.save();
     painter.translate(QPointF(docRect.x(),docRect.y()));
+    painter.scale(factor, factor);
+    doc->drawContents(&painter, QRectF(0,0,docRect.width()/factor,docRect.height()/factor));
+    painter.restore();
+}
+
+QTextDocument *PDFGeneratorWorker::text_layout(const QString &html, const QSizeF &pageSize){
 
-    m_doc->setIndentWidth(0);
-    m_doc->drawContents(&painter, QRectF(0,0,docRect.width(),docRect.height()));
-    painter.translate(QPointF(-docRect.x(),-docRect.y()));
+    // reference sizes are rounded, the same page size computed at different resolutions gives the same key
+    QSizeF size(qRound(pageSize.width()*10.)/10., qRound(pageSize.height()*10.)/10.);
+    QString key = QString::number(size.width()) + "x" + QString::number(size.height()) + "\n" + html;
+
+    QTextDocument *doc = m_textLayouts.object(key);
+    Counters::hit(Counter::TextLayoutsHits, Counter::TextLayoutsMisses, doc != nullptr);
+    if(doc != nullptr){
+        return doc;
+    }
+
+    // the resources are loaded from the parent document
+    doc = new ChildTextDocument(m_doc.get());
+    doc->setUseDesignMetrics(true);
+    doc->setIndentWidth(0);
+    doc->setPageSize(size);
+    doc->setHtml(html);
+    doc->documentLayout(); // lay out now, not at the first draw
+    m_textLayouts.insert(key, doc);
+    return doc;
 }
 
 void PDFGeneratorWorker::kill(){
@@ -473,38 +743,33 @@ void PDFGeneratorWorker::kill(){
     m_continueLoop = false;
 }
 
-void PDFGeneratorWorker::generate_preview(pc::PCPages pcPages, int pageIdToDraw, bool drawZones){
+QImage PDFGeneratorWorker::render_page(const PCPages &pcPages, int pageIdToDraw, const QSizeF &size, qreal factorUpscale, bool drawZones, SPCPage &laidOutPage, const QRect &region){
 
-    m_pageToDraw    = pcPages.pages[pageIdToDraw];
-    int dpi = pcPages.settings.paperFormat.dpi;
-    if(dpi > 300){
-        dpi = 300;
-    }
+    TraceSpan span("render_page");
+    QElapsedTimer timer;
+    timer.start();
 
-    QSizeF baseSizeMM = pcPages.settings.paperFormat.ratioMM;
-    qreal factorSize = 1.;
-    if(baseSizeMM.width() < baseSizeMM.height()){
-        if(baseSizeMM.height() > 10.){
-            factorSize = 10./baseSizeMM.height();
-        }
+    // create preview image
+    QImage image;
+    if(region.isEmpty()){
+        image = QImage(static_cast<int>(size.width()), static_cast<int>(size.height()), QImage::Format_RGB32);
     }else{
-        if(baseSizeMM.width() > 10.){
-            factorSize = 10./baseSizeMM.width();
-        }
+        image = QImage(region.size(), QImage::Format_RGB32);
     }
-
-    qreal widthPreview   = baseSizeMM.width()  * dpi * factorSize;
-    qreal heightPreview  = baseSizeMM.height() * dpi * factorSize;
-
-    // create preview image
-    QImage image(static_cast<int>(widthPreview), static_cast<int>(heightPreview), QImage::Format_RGB32);
     QPainter painter(&image);
+    if(!region.isEmpty()){
+        painter.translate(-region.topLeft());
+        painter.setClipRect(region);
+    }
 
-    m_pageToDraw->compute_sizes(QRectF(0 ,0, widthPreview, heightPreview));
+    // the page of the snapshot is shared with the UI, sizes are computed on a copy
+    laidOutPage = pcPages.pages[pageIdToDraw]->layout(QRectF(QPointF(0,0), size));
+    m_layoutUs = timer.nsecsElapsed()/1000;
 
-    draw_page(painter, pcPages, pageIdToDraw, 1.*factorSize*dpi/m_referenceDPI, true, drawZones);
+    draw_page(painter, pcPages, laidOutPage, pageIdToDraw, factorUpscale, true, drawZones);
 
     painter.end();
+    m_drawUs = timer.nsecsElapsed()/1000 - m_layoutUs;
 
     if(pcPages.settings.grayScale){
         for (int ii = 0; ii < image.height(); ii++) {
@@ -517,11 +782,154 @@ void PDFGeneratorWorker::generate_preview(pc::PCPages pcPages, int pageIdToDraw,
         }
     }
 
+    return image;
+}
+
+QSizeF PDFGeneratorWorker::preview_size(const PaperFormat &paperFormat, qreal dpi){
+
+    QSizeF baseSizeMM = paperFormat.ratioMM;
+    qreal factorSize = 1.;
+    if(baseSizeMM.width() < baseSizeMM.height()){
+        if(baseSizeMM.height() > 10.){
+            factorSize = 10./baseSizeMM.height();
+        }
+    }else{
+        if(baseSizeMM.width() > 10.){
+            factorSize = 10./baseSizeMM.width();
+        }
+    }
+
+    return QSizeF(baseSizeMM.width() * dpi * factorSize, baseSizeMM.height() * dpi * factorSize);
+}
+
+void PDFGeneratorWorker::generate_preview(PCPages pcPages, int pageIdToDraw, bool drawZones, QSize targetSize){
+
+    BusyScope busy(m_busyCounter);
+
+    qreal dpi = pcPages.settings.paperFormat.dpi;
+    if(dpi > maxPreviewDPI){
+        dpi = maxPreviewDPI;
+    }
+
+    // the page is rendered at the size it is displayed, sharper details are given by the zoomed tiles
+    QSizeF sizeAtDPI = preview_size(pcPages.settings.paperFormat, dpi);
+    if(targetSize.width() > 0 && targetSize.height() > 0 && sizeAtDPI.width() > 0. && sizeAtDPI.height() > 0.){
+        dpi *= std::min(1., std::min(targetSize.width()/sizeAtDPI.width(), targetSize.height()/sizeAtDPI.height()));
+    }
+
+    QSizeF size = preview_size(pcPages.settings.paperFormat, dpi);
+    if(size.width() < 1. || size.height() < 1.){
+        return;
+    }
+
+    QImage image = render_page(pcPages, pageIdToDraw, size, size.width()/(pcPages.settings.paperFormat.ratioMM.width()*m_referenceDPI), drawZones, m_pageToDraw);
+    Counters::set(Counter::PreviewLayoutUs, m_layoutUs);
+    Counters::set(Counter::PreviewDrawUs, m_drawUs);
+
+    // tiles of the previous preview are outdated
+    m_previewPages      = std::move(pcPages);
+    m_previewPageId     = pageIdToDraw;
+    m_previewDrawZones  = drawZones;
+    m_tiles.clear();
+
     emit end_preview_signal(image, m_pageToDraw);
 }
 
+void PDFGeneratorWorker::generate_preview_tiles(SPCPage previewPage, QSize pageSize, QVector<QRect> tiles){
+
+    // previous requests are outdated
+    m_tilesPage     = previewPage;
+    m_tilesPageSize = pageSize;
+    m_tiles         = std::move(tiles);
+
+    if(!m_tilesScheduled && m_tiles.size() > 0){
+        m_tilesScheduled = true;
+        QTimer::singleShot(0, this, &PDFGeneratorWorker::generate_next_preview_tiles);
+    }
+}
+
+void PDFGeneratorWorker::generate_next_preview_tiles(){
+
+    m_tilesScheduled = false;
+    if(!m_continueLoop || m_tiles.size() == 0 || m_tilesPage != m_pageToDraw || m_previewPageId >= m_previewPages.pages.size()){
+        m_tiles.clear();
+        return;
+    }
+
+    BusyScope busy(m_busyCounter);
+    TraceSpan span("preview_tiles");
+
+    // the cached tiles leave holes among the visible ones, the missing tiles are drawn by rectangular runs
+    // so that no cached tile is drawn again, one run per pass
+    QRect region;
+    QVector<QRect> runTiles = take_tiles_run(m_tiles, region);
+    region &= QRect(QPoint(0,0), m_tilesPageSize);
+
+    if(!region.isEmpty()){
+        SPCPage laidOutPage;
+        QSizeF pageSize(m_tilesPageSize);
+        qreal factorUpscale = pageSize.width()/(m_previewPages.settings.paperFormat.ratioMM.width()*m_referenceDPI);
+        QImage image = render_page(m_previewPages, m_previewPageId, pageSize, factorUpscale, m_previewDrawZones, laidOutPage, region);
+        Counters::set(Counter::PreviewTilesUs, m_layoutUs + m_drawUs);
+
+        for(const auto &tile : runTiles){
+            emit end_preview_tile_signal(m_tilesPage, m_tilesPageSize, tile, image.copy(tile.translated(-region.topLeft())));
+        }
+    }
+
+    // let the event loop process the new requests before rendering the next run
+    m_tilesScheduled = m_tiles.size() > 0;
+    if(m_tilesScheduled){
+        QTimer::singleShot(0, this, &PDFGeneratorWorker::generate_next_preview_tiles);
+    }
+}
+
+void PDFGeneratorWorker::generate_pages_thumbnails(PCPages pcPages, QVector<int> pagesId, QVector<uint> pagesHash){
+
+    // previous requests are outdated
+    m_thumbnailsPages   = std::move(pcPages);
+    m_thumbnailsPagesId = std::move(pagesId);
+    m_thumbnailsHash    = std::move(pagesHash);
+
+    if(!m_thumbnailScheduled && m_thumbnailsPagesId.size() > 0){
+        m_thumbnailScheduled = true;
+        QTimer::singleShot(0, this, &PDFGeneratorWorker::generate_next_page_thumbnail);
+    }
+}
+
+void PDFGeneratorWorker::generate_next_page_thumbnail(){
+
+    if(!m_continueLoop || m_thumbnailsPagesId.size() == 0){
+        m_thumbnailScheduled = false;
+        return;
+    }
+
+    BusyScope busy(m_busyCounter);
+    int pageId    = m_thumbnailsPagesId.takeFirst();
+    uint pageHash = m_thumbnailsHash.takeFirst();
+
+    if(pageId < m_thumbnailsPages.pages.size()){
+
+        QSizeF baseSizeMM = m_thumbnailsPages.settings.paperFormat.ratioMM;
+        QSizeF size = baseSizeMM.scaled(pageThumbnailSize, pageThumbnailSize, Qt::KeepAspectRatio);
+        if(size.width() >= 1. && size.height() >= 1.){
+            SPCPage laidOutPage;
+            QImage thumbnail = render_page(m_thumbnailsPages, pageId, size, size.width()/(baseSizeMM.width()*m_referenceDPI), false, laidOutPage);
+            emit end_page_thumbnail_signal(pageHash, thumbnail);
+        }
+    }
+
+    // let the event loop process the new requests before rendering the next one
+    m_thumbnailScheduled = m_thumbnailsPagesId.size() > 0;
+    if(m_thumbnailScheduled){
+        QTimer::singleShot(0, this, &PDFGeneratorWorker::generate_next_page_thumbnail);
+    }
+}
+
 void PDFGeneratorWorker::generate_PDF(pc::PCPages pcPages){
 
+    BusyScope busy(m_busyCounter);
+
     int nbTotalPC = 0;
     for(auto &&page : pcPages.pages){
         nbTotalPC += page->sets.size();
@@ -530,64 +938,302 @@ void PDFGeneratorWorker::generate_PDF(pc::PCPages pcPages){
     m_totalPC = nbTotalPC;
     emit set_progress_bar_state_signal(0);
 
-    QPrinter pdfWriter(QPrinter::HighResolution);
-    pdfWriter.setOutputFormat(QPrinter::PdfFormat);
-    pdfWriter.setOutputFileName(pcPages.pdfFileName);
-    pdfWriter.setCreator("created with PhotosConsigne (https://github.com/FlorianLance/PhotosConsigne)");
-    pdfWriter.setColorMode(pcPages.settings.grayScale ? QPrinter::ColorMode::GrayScale : QPrinter::ColorMode::Color);
-    pdfWriter.setResolution(pcPages.settings.paperFormat.dpi);
-
-    if(pcPages.settings.paperFormat.isCustom){
-        pdfWriter.setPageSize(QPageSize(pcPages.settings.paperFormat.sizeMM, QPageSize::Millimeter));
-        pdfWriter.setPageOrientation(QPageLayout::Portrait);
-    }else{
-        pdfWriter.setPageSize(QPageSize(static_cast<QPageSize::PageSizeId>(pcPages.settings.paperFormat.format)));
-        pdfWriter.setPageOrientation(pcPages.settings.paperFormat.isLandScape ? QPageLayout::Landscape : QPageLayout::Portrait);
+    if(m_exportDir == nullptr){
+        m_exportDir = std::make_unique<QTemporaryDir>();
     }
-
-    pdfWriter.setPageMargins(QMarginsF(0.,0.,0.,0.));
-
-    // init painter
-    QPainter pdfPainter;
-    pdfPainter.setRenderHints(QPainter::Antialiasing, true);
-    pdfPainter.setPen(Qt::NoPen);
-    if(!pdfPainter.begin(&pdfWriter)){
-        qWarning() << "-Error: can't write on file: " << pcPages.pdfFileName << ", file may not exists";
-
+    if(!m_exportDir->isValid()){
+        qWarning() << "-Error: can't create the export directory: " << m_exportDir->errorString();
         emit abort_pdf_signal(pcPages.pdfFileName);
         return;
     }
 
-    pcPages.compute_all_pages_sizes(pdfWriter.width(), pdfWriter.height());
+    // texts tags values common to all the pages, as in draw_page
+    ExtraPCInfo documentInfos;
+    documentInfos.pagesNb       = pcPages.pages.size();
+    documentInfos.photoNum      = 0;
+    documentInfos.photoPCNum    = 0;
+    documentInfos.paperFormat   = pcPages.settings.paperFormat;
+    for(auto &&page : pcPages.pages){
+        documentInfos.photoTotalNum += page->sets.size();
+    }
+
+    // each page is rendered alone in a file, even for the first export, the pages unchanged since the last export reuse their file
+    QStringList pagesFiles;
+    QHash<const PCPage*, ExportedPage> exportedPages;
+    QVector<QPair<int,QString>> pagesToRender;
     for(int ii = 0; ii < pcPages.pages.size(); ++ii){
 
         if(!pcPages.pages[ii]->drawThisPage){
             continue;
         }
 
-        if(ii > 0){
-            pdfWriter.newPage();
+        const PCPage *key = pcPages.pages[ii].get();
+        QByteArray hash = export_hash(pcPages, ii, documentInfos);
+
+        auto previous = m_exportedPages.find(key);
+        bool reused = previous != m_exportedPages.end() && previous.value().hash == hash && QFile::exists(previous.value().file);
+        Counters::hit(Counter::ExportedPagesHits, Counter::ExportedPagesMisses, reused);
+
+        ExportedPage page;
+        if(reused){
+            page = previous.value();
+        }else{
+
+            if(previous != m_exportedPages.end()){
+                QFile::remove(previous.value().file);
+            }
+
+            page.page = pcPages.pages[ii];
+            page.hash = hash;
+            page.file = m_exportDir->filePath("page_" + QString::number(m_nbExportedFiles++) + ".pdf");
+            pagesToRender.push_back({ii, page.file});
         }
 
-        if(!m_continueLoop)
-            return;
+        exportedPages[key] = page;
+        pagesFiles << page.file;
+    }
 
-        emit set_progress_bar_text_signal("Création page " + QString::number(ii));
+    bool rendered = export_pages(pcPages, pagesToRender);
 
-        qreal factor = 1.*pcPages.settings.paperFormat.dpi/m_referenceDPI;
-        draw_page(pdfPainter, pcPages, ii, factor, false, false);
+    // the pdf layers hold the photos at the document resolution
+    m_backgroundLayers.clear();
 
-        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    if(!rendered){
+        if(m_continueLoop){
+            emit abort_pdf_signal(pcPages.pdfFileName);
+        }
+        return;
     }
 
-    // end pdf writing
-    pdfPainter.end();
+    // files of the pages not in the document anymore
+    for(auto it = m_exportedPages.begin(); it != m_exportedPages.end(); ++it){
+        if(!exportedPages.contains(it.key())){
+            QFile::remove(it.value().file);
+        }
+    }
+    m_exportedPages = std::move(exportedPages);
+
+    emit set_progress_bar_text_signal("Ecriture du PDF...");
+    if(!PdfMerger::merge(pagesFiles, pcPages.pdfFileName)){
+        emit abort_pdf_signal(pcPages.pdfFileName);
+        return;
+    }
 
     emit set_progress_bar_state_signal(1000);
     emit end_generation_signal(true);
 }
 
+QByteArray PDFGeneratorWorker::export_hash(const PCPages &pcPages, int pageId, const ExtraPCInfo &documentInfos) const{
+
+    // a collision would put a wrong page in the document, the inputs are not reduced to a 32 bits qHash
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto add = [&](const auto &value){
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto add_text = [&](const QString &text){
+        add(text.size());
+        hash.addData(reinterpret_cast<const char*>(text.constData()), text.size() * static_cast<int>(sizeof(QChar)));
+    };
+
+    // # document, same inputs as page_hash with the export resolution and paper
+    const auto &paperFormat = pcPages.settings.paperFormat;
+    add(pageId);
+    add(pcPages.settings.grayScale);
+    add(paperFormat.ratioMM.width());
+    add(paperFormat.ratioMM.height());
+    add(paperFormat.dpi);
+    add(paperFormat.isCustom);
+    add(paperFormat.isLandScape);
+    add(static_cast<int>(paperFormat.format));
+    add(paperFormat.sizeMM.width());
+    add(paperFormat.sizeMM.height());
+
+    // the photos are read from their files, thumbnails may be decoded after the creation of the settings or of the set
+    auto add_photo = [&](const Photo *photo){
+        if(photo != nullptr){
+            add_text(photo->pathPhoto);
+            add(photo->rotation);
+            add(photo->scaledPhoto.cacheKey());
+            if(!photo->isWhiteSpace){
+                add(photo->lastModified.toMSecsSinceEpoch());
+            }
+        }
+    };
+
+    // # page
+    const SCPCPage &page = pcPages.pages[pageId];
+    add(page->settings->uid);
+    add(page->header->settings->uid);
+    add(page->footer->settings->uid);
+    add_photo(page->settings->background.photo.get());
+    add_photo(page->header->settings->background.photo.get());
+    add_photo(page->footer->settings->background.photo.get());
+
+    // # sets
+    for(const auto &set : page->sets){
+        add(set->settings->uid);
+        add(set->totalId);
+        add_photo(set->photo.get());
+    }
+
+    // # texts, with their tags replaced (date, numbers, names...) as in draw_page
+    ExtraPCInfo infos = documentInfos;
+    infos.pageNum  = pageId;
+    infos.pageName = page->settings->name;
+
+    auto add_html = [&](const std::shared_ptr<QString> &html){
+        if(html != nullptr){
+            add_text(Drawing::format_html_for_generation(*html, infos));
+        }
+    };
+    add_html(page->header->settings->text.html);
+    add_html(page->footer->settings->text.html);
+    for(const auto &set : page->sets){
+        if(set->photo != nullptr){
+            infos.photoNum              = set->totalId;
+            infos.photoPCNum            = set->id;
+            infos.namePCAssociatedPhoto = set->photo->namePhoto;
+            infos.fileDate              = set->photo->lastModified;
+            infos.photoMetadata         = set->photo->metadata;
+        }
+        add_html(set->settings->text.html);
+    }
+
+    return hash.result();
+}
+
+std::unique_ptr<QPagedPaintDevice> PDFGeneratorWorker::create_pdf_writer(const PCPages &pcPages, const QString &fileName) const{
+
+    const QString creator = "created with PhotosConsigne (https://github.com/FlorianLance/PhotosConsigne)";
+    const int dpi = pcPages.settings.paperFormat.dpi;
+
+    // a QPdfWriter doesn't load the print plugin nor query the default printer,
+    // a QPrinter is only kept for the grayscale mode which the writer doesn't have
+    std::unique_ptr<QPagedPaintDevice> pdfWriter;
+    if(pcPages.settings.grayScale){
+        auto printer = std::make_unique<QPrinter>(QPrinter::HighResolution);
+        printer->setOutputFormat(QPrinter::PdfFormat);
+        printer->setOutputFileName(fileName);
+        printer->setCreator(creator);
+        printer->setColorMode(QPrinter::ColorMode::GrayScale);
+        printer->setResolution(dpi);
+        pdfWriter = std::move(printer);
+    }else{
+        auto writer = std::make_unique<QPdfWriter>(fileName);
+        writer->setCreator(creator);
+        writer->setResolution(dpi);
+        pdfWriter = std::move(writer);
+    }
+
+    if(pcPages.settings.paperFormat.isCustom){
+        pdfWriter->setPageSize(QPageSize(pcPages.settings.paperFormat.sizeMM, QPageSize::Millimeter));
+        pdfWriter->setPageOrientation(QPageLayout::Portrait);
+    }else{
+        pdfWriter->setPageSize(QPageSize(static_cast<QPageSize::PageSizeId>(pcPages.settings.paperFormat.format)));
+        pdfWriter->setPageOrientation(pcPages.settings.paperFormat.isLandScape ? QPageLayout::Landscape : QPageLayout::Portrait);
+    }
+
+    pdfWriter->setPageMargins(QMarginsF(0.,0.,0.,0.));
+    return pdfWriter;
+}
+
+bool PDFGeneratorWorker::export_pages(const PCPages &pcPages, const QVector<QPair<int, QString>> &pages){
+
+    const int nbShards = std::min(pages.size(), std::max(1, QThread::idealThreadCount()));
+    if(nbShards <= 1){
+        for(const auto &page : pages){
+
+            if(!m_continueLoop){
+                return false;
+            }
+
+            emit set_progress_bar_text_signal("Création page " + QString::number(page.first));
+            if(!export_page(pcPages, page.first, page.second)){
+                return false;
+            }
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+        return true;
+    }
+
+    // the text documents are not shared between threads, each shard adds copies of the resources to its own
+    const QVector<QUrl> resourcesUrl       = droppedUrl + insertedUrl;
+    const QVector<QImage> resourcesImages  = droppedImages + insertedImages;
+
+    // contiguous ranges of pages, each one rendered with its own printers, caches and text document
+    std::atomic<int> nbRendered{0};
+    const int nbPages = pages.size();
+    QEventLoop loop;
+    int nbRunning = nbShards;
+    std::vector<std::unique_ptr<QFutureWatcher<bool>>> shards;
+    for(int ii = 0; ii < nbShards; ++ii){
+
+        int begin = pages.size() * ii / nbShards;
+        int end   = pages.size() * (ii+1) / nbShards;
+        QVector<QPair<int,QString>> range = pages.mid(begin, end - begin);
+
+        shards.emplace_back(std::make_unique<QFutureWatcher<bool>>());
+        connect(shards.back().get(), &QFutureWatcher<bool>::finished, &loop, [&]{
+            if(--nbRunning == 0){
+                loop.quit();
+            }
+        });
+        shards.back()->setFuture(QtConcurrent::run([this, &pcPages, &nbRendered, nbPages, range, resourcesUrl, resourcesImages]{
+
+            // the resources are only added to the text document, the resources counter is kept by the worker
+            PDFGeneratorWorker renderer;
+            renderer.init_document();
+            renderer.m_totalPC = m_totalPC;
+            for(int jj = 0; jj < resourcesUrl.size(); ++jj){
+                renderer.m_doc->addResource(QTextDocument::ImageResource, resourcesUrl[jj], resourcesImages[jj]);
+            }
+
+            for(const auto &page : range){
+                if(!m_continueLoop || !renderer.export_page(pcPages, page.first, page.second)){
+                    return false;
+                }
+                emit set_progress_bar_text_signal("Création des pages " + QString::number(++nbRendered) + "/" + QString::number(nbPages));
+            }
+            return true;
+        }));
+    }
+
+    // the worker keeps processing its events while the shards render, previews and zoomed tiles are still generated
+    loop.exec();
+
+    bool success = true;
+    for(const auto &shard : shards){
+        success &= shard->result();
+    }
+
+    return success;
+}
+
+bool PDFGeneratorWorker::export_page(const PCPages &pcPages, int pageId, const QString &fileName){
+
+    TraceSpan span("write_page");
+
+    std::unique_ptr<QPagedPaintDevice> pdfWriter = create_pdf_writer(pcPages, fileName);
+
+    // init painter
+    QPainter pdfPainter;
+    pdfPainter.setRenderHints(QPainter::Antialiasing, true);
+    pdfPainter.setPen(Qt::NoPen);
+    if(!pdfPainter.begin(pdfWriter.get())){
+        qWarning() << "-Error: can't write on file: " << fileName;
+        return false;
+    }
+
+    QRectF pageRect(0, 0, pdfWriter->width(), pdfWriter->height());
+    qreal factor = 1.*pcPages.settings.paperFormat.dpi/m_referenceDPI;
+    draw_page(pdfPainter, pcPages, pcPages.pages[pageId]->layout(pageRect), pageId, factor, false, false);
+
+    return pdfPainter.end();
+}
+
 void PDFGeneratorWorker::init_document(){
+    m_textLayouts.clear();
+    m_exportedPages.clear();
     m_doc = std::make_unique<QTextDocument>();
 }
 
@@ -601,5 +1247,8 @@ void PDFGeneratorWorker::add_resource(QUrl url, QImage image){
         insertedImages.push_back(image);
     }
 
+    m_resourcesBytes += static_cast<qint64>(image.bytesPerLine()) * image.height();
+    Counters::set(Counter::PdfResourcesBytes, m_resourcesBytes);
+
     m_doc->addResource(QTextDocument::ImageResource, std::move(url), std::move(image));    
 }
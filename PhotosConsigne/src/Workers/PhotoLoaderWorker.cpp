@@ -35,9 +35,63 @@
 // local
 #include "PhotoLoaderWorker.hpp"
 #include "DocumentElements.hpp"
+#include "DirectoryScannerWorker.hpp"
+#include "Counters.hpp"
+#include "DebugMessage.hpp"
 
 // Qt
 #include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent>
+
+// std
+#include <algorithm>
+
+namespace {
+
+    // number of decoding batches read ahead by the prefetcher
+    const int batchesReadAhead = 4;
+
+    QImage decode_thumbnail(const QString &path){
+        return pc::Photo::read_thumbnail(path);
+    }
+
+    /**
+     * @brief Decode the thumbnail of a file taken from the prefetcher, in the decoding thread
+     */
+    struct PrefetchedThumbnail{
+
+        using result_type = QImage;
+
+        QImage operator()(const QString &path) const{
+            return pc::Photo::read_thumbnail(path, prefetcher->take(path));
+        }
+
+        pc::FilePrefetcher *prefetcher;
+    };
+
+    /**
+     * @brief Create a photo from its work file element, reading only the header of its file
+     */
+    pc::SPhoto photo_from_work(const QXmlStreamAttributes &attributes){
+
+        pc::SPhoto photo = std::make_shared<pc::Photo>(attributes.value("path").toString(), attributes.value("white").toInt(), false);
+        photo->id           = attributes.value("id").toInt();
+        photo->pageId       = attributes.value("pageId").toInt();
+        photo->loadedId     = attributes.value("loadedId").toInt();
+        photo->rotation     = attributes.value("rotation").toInt();
+        photo->scaledPhoto  = photo->scaledPhoto.transformed(QTransform().rotate(photo->rotation));
+        photo->thumbnailBytes.update(photo->scaledPhoto);
+        photo->isADuplicate = attributes.value("duplicate").toInt();
+        photo->isOnDocument = attributes.value("onDoc").toInt();
+        photo->isRemoved    = attributes.value("removed").toInt();
+        return photo;
+    }
+}
 
 pc::PhotoLoaderWorker::PhotoLoaderWorker(){
 
@@ -48,12 +102,41 @@ pc::PhotoLoaderWorker::PhotoLoaderWorker(){
     qRegisterMetaType<PCPage>("PCPage");
     qRegisterMetaType<SPCPage>("SPCPage");
     qRegisterMetaType<QVector<QRectF>>("QVector<QRectF>");
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+    qRegisterMetaType<QVector<uint>>("QVector<uint>");
     qRegisterMetaType<QReadWriteLock *>("QReadWriteLock *");
+    qRegisterMetaType<QVector<QXmlStreamAttributes>>("QVector<QXmlStreamAttributes>");
+}
+
+void pc::PhotoLoaderWorker::load_work_photos(QVector<QXmlStreamAttributes> photosAttributes){
+
+    BusyScope busy(Counter::PhotoLoaderBusyUs);
+
+    // headers read in parallel
+    emit set_progress_bar_text_signal("Lecture des en-têtes des photos...");
+    SPhotos photos = std::make_shared<Photos>(QtConcurrent::blockingMapped<QList<SPhoto>>(photosAttributes, &photo_from_work));
+
+    // EXIF headers, the saved rotations are kept
+    QStringList photosPath;
+    for(const auto &photo : *photos){
+        if(!photo->isWhiteSpace){
+            photosPath << photo->pathPhoto;
+        }
+    }
+    MetadataIndex::index(photosPath);
+    for(auto &&photo : *photos){
+        if(!photo->isWhiteSpace){
+            photo->set_metadata(MetadataIndex::get(photo->pathPhoto), false);
+        }
+    }
+
+    emit work_photos_loaded_signal(photos);
 }
 
 
 void pc::PhotoLoaderWorker::load_photos_directory(QStringList photosPath, int startIndexToInsert){
 
+    BusyScope busy(Counter::PhotoLoaderBusyUs);
 
     emit set_progress_bar_state_signal(0);
     emit set_progress_bar_text_signal("Chargement des photos...");
@@ -68,8 +151,12 @@ void pc::PhotoLoaderWorker::load_photos_directory(QStringList photosPath, int st
     qreal offset = 750 / nbPhotos;
     qreal currentState = 0;
 
-    SPhotos photosLoaded = std::make_shared<QList<SPhoto>>();
-    photosLoaded->reserve(nbPhotos);
+    m_readingHeaders = true;
+
+    // EXIF headers of all the photos are read in parallel before creating them
+    emit set_progress_bar_text_signal("Lecture des métadonnées des photos...");
+    MetadataIndex::index(photosPath);
+
     for(const auto &photoPath : photosPath){
 
         QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
@@ -89,9 +176,12 @@ void pc::PhotoLoaderWorker::load_photos_directory(QStringList photosPath, int st
 //            splitPath = splitPath.insert(30, "\n");
         }
         emit set_progress_bar_text_signal("Chargement de " + splitPath);
-        SPhoto photo = std::make_shared<Photo>(Photo(photoPath));
-        if(!photo->scaledPhoto.isNull()){
-            photosLoaded->push_back(photo);
+        SPhoto photo = std::make_shared<Photo>(Photo(photoPath, false, false));
+        if(photo->size().isValid()){
+            photo->set_metadata(MetadataIndex::get(photoPath), true);
+            if(!photo->isLoaded){
+                m_thumbnailsToDecode.push_back(photo);
+            }
             emit photo_loaded_signal(photo, idPhoto);
         }
         else{
@@ -102,9 +192,316 @@ void pc::PhotoLoaderWorker::load_photos_directory(QStringList photosPath, int st
         ++idPhoto;
         emit set_progress_bar_state_signal(static_cast<int>(currentState));
     }
+    m_readingHeaders = false;
+    Counters::set(Counter::DecodeQueue, m_thumbnailsToDecode.size());
+
+    // a stopped loading must not drop the batches of the next directory scan
+    m_locker.lockForWrite();
+    m_continueLoop = true;
+    m_locker.unlock();
+
+    emit set_progress_bar_state_signal(750);
+    emit end_loading_photos_signal();
+
+    // start decoding the thumbnails in background
+    if(!m_decodingScheduled && m_thumbnailsToDecode.size() > 0){
+        m_decodingScheduled = true;
+        QTimer::singleShot(0, this, &PhotoLoaderWorker::decode_next_thumbnail);
+    }
+}
+
+void pc::PhotoLoaderWorker::start_appending_photos(){
+
+    m_locker.lockForWrite();
+    m_continueLoop = true;
+    m_locker.unlock();
+
+    m_endOfAppending = false;
+    m_nbAppended = 0;
+    m_nbToAppend = 0;
+}
+
+void pc::PhotoLoaderWorker::append_photos(QStringList photosPath){
+
+    bool continueLoop;
+    m_locker.lockForRead();
+    continueLoop = m_continueLoop;
+    m_locker.unlock();
+
+    // loading stopped, the remaining batches of the scan are dropped
+    if(!continueLoop){
+        return;
+    }
+
+    m_photosToAppend.append(photosPath);
+    m_nbToAppend += photosPath.size();
+
+    // called again from the events processing of the loop below, the batch is read by it
+    if(m_readingHeaders){
+        return;
+    }
+
+    BusyScope busy(Counter::PhotoLoaderBusyUs);
+
+    m_readingHeaders = true;
+    while(m_photosToAppend.size() > 0 && continueLoop){
+
+        QStringList batch = m_photosToAppend;
+        m_photosToAppend.clear();
+
+        emit set_progress_bar_text_signal("Lecture des métadonnées des photos...");
+        MetadataIndex::index(batch);
+
+        for(const auto &photoPath : batch){
+
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+
+            m_locker.lockForRead();
+            continueLoop = m_continueLoop;
+            m_locker.unlock();
+
+            if(!continueLoop){
+                m_photosToAppend.clear();
+                break;
+            }
+
+            emit set_progress_bar_text_signal("Chargement de " + photoPath);
+            SPhoto photo = std::make_shared<Photo>(Photo(photoPath, false, false));
+            if(photo->size().isValid()){
+                photo->set_metadata(MetadataIndex::get(photoPath), true);
+                if(!photo->isLoaded){
+                    m_thumbnailsToDecode.push_back(photo);
+                }
+                emit photo_loaded_signal(photo, -1);
+            }
+            else{
+                emit set_progress_bar_text_signal("Echec chargement photo " + photoPath);
+            }
+
+            // the total grows with the scan
+            ++m_nbAppended;
+            emit set_progress_bar_state_signal(750 * m_nbAppended / std::max(1, m_nbToAppend));
+        }
+    }
+    m_readingHeaders = false;
+    Counters::set(Counter::DecodeQueue, m_thumbnailsToDecode.size());
+
+    // end of the scan received during the reading
+    if(m_endOfAppending){
+        end_appending_photos();
+        return;
+    }
+
+    // decode the thumbnails of the photos already read while the scan goes on
+    if(!m_decodingScheduled && m_thumbnailsToDecode.size() > 0){
+        m_decodingScheduled = true;
+        QTimer::singleShot(0, this, &PhotoLoaderWorker::decode_next_thumbnail);
+    }
+}
+
+void pc::PhotoLoaderWorker::end_appending_photos(){
+
+    if(m_readingHeaders){
+        m_endOfAppending = true;
+        return;
+    }
+
+    m_endOfAppending = false;
+    m_nbAppended = 0;
+    m_nbToAppend = 0;
+
+    // a stopped loading is allowed again for the next scan
+    m_locker.lockForWrite();
+    m_continueLoop = true;
+    m_locker.unlock();
 
     emit set_progress_bar_state_signal(750);
     emit end_loading_photos_signal();
+
+    if(!m_decodingScheduled && m_thumbnailsToDecode.size() > 0){
+        m_decodingScheduled = true;
+        QTimer::singleShot(0, this, &PhotoLoaderWorker::decode_next_thumbnail);
+    }
+}
+
+void pc::PhotoLoaderWorker::decode_thumbnails(SPhotos photos){
+
+    for(const auto &photo : *photos){
+        if(!photo->isLoaded){
+            m_thumbnailsToDecode.push_back(photo);
+        }
+    }
+    Counters::set(Counter::DecodeQueue, m_thumbnailsToDecode.size());
+
+    if(!m_readingHeaders && !m_decodingScheduled && m_thumbnailsToDecode.size() > 0){
+        m_decodingScheduled = true;
+        QTimer::singleShot(0, this, &PhotoLoaderWorker::decode_next_thumbnail);
+    }
+}
+
+void pc::PhotoLoaderWorker::reload_photos(SPhotos photos){
+
+    BusyScope busy(Counter::PhotoLoaderBusyUs);
+
+    // duplicated photos share the same file
+    QStringList photosPath;
+    for(const auto &photo : *photos){
+        if(!photosPath.contains(photo->pathPhoto)){
+            photosPath << photo->pathPhoto;
+        }
+    }
+    MetadataIndex::reindex(photosPath);
+
+    for(auto &&photo : *photos){
+        photo->reload_header();
+        photo->set_metadata(MetadataIndex::get(photo->pathPhoto), false);
+    }
+
+    emit photos_reloaded_signal(photos);
+}
+
+void pc::PhotoLoaderWorker::prioritize_photos(SPhotos photos){
+
+    if(m_thumbnailsToDecode.size() == 0){
+        return;
+    }
+
+    QSet<Photo*> prioritized;
+    prioritized.reserve(photos->size());
+    for(const auto &photo : *photos){
+        prioritized.insert(photo.get());
+    }
+
+    // keep the order given for the prioritized photos, then the previous order for the others
+    QHash<Photo*, std::weak_ptr<Photo>> queued;
+    QList<std::weak_ptr<Photo>> others;
+    others.reserve(m_thumbnailsToDecode.size());
+    for(auto &&weakPhoto : m_thumbnailsToDecode){
+        SPhoto photo = weakPhoto.lock();
+        if(photo == nullptr){
+            continue;
+        }
+
+        if(prioritized.contains(photo.get())){
+            queued[photo.get()] = weakPhoto;
+        }else{
+            others.push_back(weakPhoto);
+        }
+    }
+
+    QList<std::weak_ptr<Photo>> newQueue;
+    newQueue.reserve(queued.size() + others.size());
+    for(const auto &photo : *photos){
+        auto it = queued.find(photo.get());
+        if(it != queued.end()){
+            newQueue.push_back(it.value());
+            queued.erase(it);
+        }
+    }
+    newQueue.append(others);
+
+    m_thumbnailsToDecode = std::move(newQueue);
+}
+
+void pc::PhotoLoaderWorker::decode_next_thumbnail(){
+
+    // headers reading has the priority, decoding will be rescheduled at its end
+    if(m_readingHeaders){
+        m_decodingScheduled = false;
+        return;
+    }
+
+    BusyScope busy(Counter::PhotoLoaderBusyUs);
+
+    // decode the next photos of the queue in parallel, a small batch keeps the priorities responsive
+    QList<SPhoto> photos;
+    QStringList paths;
+    int batchSize = std::max(1, QThread::idealThreadCount());
+    while(photos.size() < batchSize && m_thumbnailsToDecode.size() > 0){
+        SPhoto photo = m_thumbnailsToDecode.takeFirst().lock();
+        if(photo != nullptr){
+            photos << photo;
+            paths << photo->pathPhoto;
+        }
+    }
+
+    if(photos.size() > 0){
+
+        // the next files of the queue are read while this batch is decoded
+        QStringList upcoming = paths;
+        for(int ii = 0; ii < m_thumbnailsToDecode.size() && upcoming.size() < batchSize*(1+batchesReadAhead); ++ii){
+            SPhoto photo = m_thumbnailsToDecode[ii].lock();
+            if(photo != nullptr){
+                upcoming << photo->pathPhoto;
+            }
+        }
+        m_prefetcher.prefetch(upcoming);
+
+        // each decoder waits only for its own file
+        QList<QImage> thumbnails = QtConcurrent::blockingMapped<QList<QImage>>(paths, PrefetchedThumbnail{&m_prefetcher});
+        for(int ii = 0; ii < photos.size(); ++ii){
+            emit thumbnail_loaded_signal(photos[ii], thumbnails[ii]);
+        }
+    }
+
+    Counters::set(Counter::DecodeQueue, m_thumbnailsToDecode.size());
+
+    // let the event loop process the new priorities before decoding the next one
+    m_decodingScheduled = m_thumbnailsToDecode.size() > 0;
+    if(m_decodingScheduled){
+        QTimer::singleShot(0, this, &PhotoLoaderWorker::decode_next_thumbnail);
+    }
+    if(!m_decodingScheduled){
+        m_prefetcher.clear();
+    }
+}
+
+void pc::PhotoLoaderWorker::benchmark_decoding(const QString &directory){
+
+    // same formats than the directories imports
+    const QSet<QString> suffixes = DirectoryScannerWorker::supported_suffixes();
+    QStringList paths;
+    for(const auto &info : QDir(directory).entryInfoList(QDir::Files, QDir::Name)){
+        if(suffixes.contains(info.suffix().toLower())){
+            paths << info.filePath();
+        }
+    }
+    if(paths.size() == 0){
+        qWarning() << "-Error: no photo found in directory: " << directory;
+        return;
+    }
+
+    const int batchSize = std::max(1, QThread::idealThreadCount());
+    auto cold_time = [&](bool prefetch){
+
+        int nbEvicted = 0;
+        for(const auto &path : paths){
+            nbEvicted += FilePrefetcher::evict_from_cache(path) ? 1 : 0;
+        }
+        if(nbEvicted < paths.size()){
+            qWarning() << "-Error: only" << nbEvicted << "files on" << paths.size() << "evicted from the system cache";
+        }
+
+        // batches decoded as in decode_next_thumbnail, each decoder waits only for its own file
+        FilePrefetcher prefetcher;
+        QElapsedTimer timer;
+        timer.start();
+        for(int ii = 0; ii < paths.size(); ii += batchSize){
+            QStringList batch = paths.mid(ii, batchSize);
+            if(prefetch){
+                prefetcher.prefetch(paths.mid(ii, batchSize*(1+batchesReadAhead)));
+                QtConcurrent::blockingMapped<QList<QImage>>(batch, PrefetchedThumbnail{&prefetcher});
+            }else{
+                QtConcurrent::blockingMapped<QList<QImage>>(batch, &decode_thumbnail);
+            }
+        }
+        return timer.nsecsElapsed() * 0.000001;
+    };
+
+    double directTime   = cold_time(false);
+    double prefetchTime = cold_time(true);
+    benchmark_report(QString("thumbnails decoding benchmark: photos %1 | cold direct reads %2 ms | cold prefetched reads %3 ms")
+                     .arg(paths.size()).arg(directTime).arg(prefetchTime));
 }
 
 void pc::PhotoLoaderWorker::kill(){
@@ -0,0 +1,162 @@
+
+
+/*******************************************************************************
+** PhotosConsigne                                                             **
+** MIT License                                                                **
+** Copyright (c) [2016] [Florian Lance]                                       **
+**                                                                            **
+** Permission is hereby granted, free of charge, to any person obtaining a    **
+** copy of this software and associated documentation files (the "Software"), **
+** to deal in the Software without restriction, including without limitation  **
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,   **
+** and/or sell copies of the Software, and to permit persons to whom the      **
+** Software is furnished to do so, subject to the following conditions:       **
+**                                                                            **
+** The above copyright notice and this permission notice shall be included in **
+** all copies or substantial portions of the Software.                        **
+**                                                                            **
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR **
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   **
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    **
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER **
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    **
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        **
+** DEALINGS IN THE SOFTWARE.                                                  **
+**                                                                            **
+********************************************************************************/
+
+/**
+ * \file WorkSaverWorker.cpp
+ * \brief defines WorkSaverWorker/WorkSnapshot
+ * \date 19/10/2026
+ */
+
+// local
+#include "WorkSaverWorker.hpp"
+#include "WorkArchive.hpp"
+#include "Counters.hpp"
+
+// Qt
+#include <QDir>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QDebug>
+
+using namespace pc;
+
+WorkSaverWorker::WorkSaverWorker(ResourceStore *resourceStore) : m_resourceStore(resourceStore){
+
+    qRegisterMetaType<WorkSnapshot>("WorkSnapshot");
+}
+
+void WorkSaverWorker::save_work(WorkSnapshot snapshot){
+
+    BusyScope busy(Counter::WorkSaverBusyUs);
+
+    bool success = snapshot.binary ? save_archive(snapshot) : save_xml(snapshot);
+    if(!success){
+        qWarning() << "-Error: WorkSaverWorker::save_work -> work not saved: " << snapshot.filePath;
+    }
+    emit work_saved_signal(snapshot.filePath, success);
+}
+
+bool WorkSaverWorker::save_xml(const WorkSnapshot &snapshot){
+
+    QSaveFile file(snapshot.filePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)){
+        return false;
+    }
+
+    QString dirResourcesPath = snapshot.filePath;
+    dirResourcesPath.resize(dirResourcesPath.size()-5);
+    dirResourcesPath += "_resources";
+
+    QDir dirResources(dirResourcesPath);
+    if(!dirResources.exists()){
+        dirResources.mkdir(".");
+    }
+
+    QXmlStreamWriter xml;
+    xml.setDevice(&file);
+    xml.setAutoFormatting(true);
+
+    xml.writeStartElement("Work");
+    xml.writeStartElement("Resources");
+        xml.writeAttribute("nbImages", QString::number(snapshot.resourcesUrl.size()));
+
+            // images are stored by content, only new ones are encoded
+            QSet<QString> usedResources;
+            for(int ii = 0; ii < snapshot.resourcesUrl.size(); ++ii){
+
+                QString path = m_resourceStore->store(dirResourcesPath, snapshot.resourcesImages[ii]);
+                if(path.size() > 0){
+                    usedResources << QFileInfo(path).fileName();
+                    xml.writeStartElement("ImageAdded");
+                    xml.writeAttribute("url", snapshot.resourcesUrl[ii].toString());
+                    xml.writeAttribute("path", path);
+                    xml.writeEndElement();
+                }
+            }
+
+    xml.writeEndElement();
+    xml.writeStartElement("Photos");
+        xml.writeAttribute("number", QString::number(snapshot.photos.size()));
+        for(const auto &photo : snapshot.photos){
+            xml.writeStartElement("Photo");
+            xml.writeAttribute("path", photo->pathPhoto);
+            xml.writeAttribute("id", QString::number(photo->id));
+            xml.writeAttribute("pageId", QString::number(photo->pageId));
+            xml.writeAttribute("loadedId", QString::number(photo->loadedId));
+            xml.writeAttribute("rotation", QString::number(photo->rotation));
+            xml.writeAttribute("white", QString::number(photo->isWhiteSpace));
+            xml.writeAttribute("duplicate", QString::number(photo->isADuplicate));
+            xml.writeAttribute("onDoc", QString::number(photo->isOnDocument));
+            xml.writeAttribute("removed", QString::number(photo->isRemoved));
+            xml.writeEndElement();
+        }
+    xml.writeEndElement();
+
+    // # document settings written by the widgets
+    QXmlStreamReader settings(snapshot.settings);
+    while(!settings.atEnd() && !settings.hasError()) {
+        settings.readNext();
+        if(!settings.isStartDocument() && !settings.isEndDocument()){
+            xml.writeCurrentToken(settings);
+        }
+    }
+
+    xml.writeEndElement();
+    xml.writeEndDocument();
+
+    if(xml.hasError() || settings.hasError()){
+        file.cancelWriting();
+        return false;
+    }
+    if(!file.commit()){
+        return false;
+    }
+
+    // remove the images not used anymore by the work, once it's written
+    ResourceStore::collect_garbage(dirResourcesPath, usedResources);
+    return true;
+}
+
+bool WorkSaverWorker::save_archive(const WorkSnapshot &snapshot){
+
+    WorkArchiveContent content;
+    content.photos = std::make_shared<Photos>(snapshot.photos);
+    content.settings = snapshot.settings;
+
+    // # resources, encoded once per content
+    for(int ii = 0; ii < snapshot.resourcesUrl.size(); ++ii){
+        QByteArray data = m_resourceStore->png_data(snapshot.resourcesImages[ii]);
+        if(data.size() > 0){
+            content.resourcesUrl  << snapshot.resourcesUrl[ii];
+            content.resourcesKey  << m_resourceStore->content_key(snapshot.resourcesImages[ii]);
+            content.resourcesData << std::move(data);
+        }
+    }
+
+    return WorkArchive::save(snapshot.filePath, content);
+}